@@ -3,10 +3,13 @@
 # EECS678
 # Adopted from CS 241 @ The University of Illinois
 
+# Every example is checked in the default tick-by-tick mode and in the
+# event-driven mode (-e), which must produce the same results.
+for $mode ("", "-e"){
 for $file (<examples/*>){
 	if( $file =~ /proc(\d+)-c(\d+)-(\w+)\.out/){
 	#	print "Proc $1 CORE $2 Proc $3\n";
-		`./simulator -c $2 -s $3 examples/proc$1.csv | tail -7 > output1`;
+		`./simulator $mode -c $2 -s $3 examples/proc$1.csv | tail -7 > output1`;
 		`tail -7 $file > output2`;
 		$diff = `diff output1 output2`;
 		if($diff){
@@ -14,5 +17,48 @@ for $file (<examples/*>){
 		}
 	}
 }
+}
+
+# Streaming (-S) only changes how the trace is loaded, so the output must match
+# the run that loads it up front, apart from the first line: a streamed CSV trace
+# is not counted.  ties.csv has jobs finishing on the same tick after others have
+# finished.
+for $mode ("", "-e", "-m"){
+for $file (<examples/*.csv>){
+	for $scheme ("fcfs", "sjf", "psjf", "pri", "ppri", "rr1", "rr2"){
+		for $cores (1, 2, 4){
+			`./simulator $mode -c $cores -s $scheme $file | tail -n +2 > output1`;
+			`./simulator $mode -S -c $cores -s $scheme $file | tail -n +2 > output2`;
+			$diff = `diff output1 output2`;
+			if($diff){
+				print "Streaming $file ($mode -c $cores -s $scheme) differs\n$diff";
+			}
+		}
+	}
+}
+}
+# sweep replays traces with its own copy of the event-driven loop, so its averages
+# must match the simulator's -v summary output for the same cell.
+for $mode ("", "-m"){
+	@rows = `./sweep $mode -j 1 -c 1,2,4 -q 1,2 examples/*.csv`;
+	shift @rows;
+	for $row (@rows){
+		($file, $scheme, $cores, $quantum, @averages) = split(' ', $row);
+		$scheme .= $quantum if($scheme eq "rr");
+		@expected = map { (split(' '))[-1] } `./simulator $mode -v summary -c $cores -s $scheme $file | head -3`;
+		if("@averages" ne "@expected"){
+			print "Sweep $file ($mode -c $cores -s $scheme) differs: @averages, simulator @expected\n";
+		}
+	}
+}
+
+# With -m, a core with nothing else queued when its quantum expires steals the
+# best job of the busiest peer instead of resuming its own.  In steal.csv that
+# happens on core 1 at time 3.
+$events = `./simulator -m -v events -c 2 -s rr2 examples/steal.csv`;
+if($events !~ /\[TIME 3\] Job 3, running on core 1, had its quantum expire\. Core 1 is now running job 4\./){
+	print "Test examples/steal.csv did not steal on quantum expiry\n";
+}
+
 #cleanup
 `rm output1 output2`;
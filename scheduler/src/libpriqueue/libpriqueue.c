@@ -1,256 +1,1829 @@
-/** @file libpriqueue.c
- */
-
-#include <stdlib.h>
-#include <stdio.h>
-
-#include "libpriqueue.h"
-
-
-/**
-  Initializes the priqueue_t data structure.
-
-  Assumtions
-    - You may assume this function will only be called once per instance of priqueue_t
-    - You may assume this function will be the first function called using an instance of priqueue_t.
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param comparer a function pointer that compares two elements.
-  See also @ref comparer-page
- */
-void priqueue_init(priqueue_t *q, int(*comp)(const void *, const void *))
-{
-	q->front = NULL;
-	q->cmp = comp;
-	q->size = 0;
-}
-
-
-/**
-  Inserts the specified element into this priority queue.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param ptr a pointer to the data to be inserted into the priority queue
-  @return The zero-based index where ptr is stored in the priority queue, where 0 indicates that ptr was stored at the front of the priority queue.
- */
-int priqueue_offer(priqueue_t *q, void *ptr)
-{
-	//node a;
-	node * new_node = (node *) malloc(sizeof(node));
-	//node_t* newNode
-	new_node->data = ptr;
-	new_node->next = NULL;
-	int retv = 0;
-	// if its the first job, make it front
-	if (q->size == 0){
-		q->front = new_node;
-	} else {
-		node * cur_node = q->front;
-		node * pre_node = q->front;
-		while(cur_node != NULL) {
-			// If we get a negative then new_node is less than cur_node
-			if(q->cmp(new_node->data, cur_node->data) < 0){
-				// If its the first node, we need a special case
-				if (cur_node == q->front){
-					q->front = new_node;
-					new_node->next = cur_node;
-				} else {
-					pre_node->next = new_node;
-					new_node->next = cur_node;
-				}
-				break;
-			}
-			// iterate the nodes
-			pre_node = cur_node;
-			cur_node = cur_node->next;
-			retv++;
-		}
-		// cmp never returned -1, so were at the end of the queue and need to have a special case
-		if (cur_node == NULL){
-			pre_node->next = new_node;
-		}
-	}
-	q->size += 1;
-	return retv;
-}
-
-/**
-  Retrieves, but does not remove, the head of this queue, returning NULL if
-  this queue is empty.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @return pointer to element at the head of the queue
-  @return NULL if the queue is empty
- */
-void *priqueue_peek(priqueue_t *q)
-{
-	void * retv;
-	if (q->front == NULL) {
-		retv = NULL;
-	} else {
-		retv = q->front->data;
-	}
-	return retv;
-}
-
-
-/**
-  Retrieves and removes the head of this queue, or NULL if this queue
-  is empty.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @return the head of this queue
-  @return NULL if this queue is empty
- */
-void * priqueue_poll(priqueue_t *q)
-{
-	node * nodev = NULL;
-	void * retv = NULL;
-	if (q->front == NULL) {
-		return NULL;
-	} else {
-		//
-		nodev = q->front;
-		q->front = nodev->next;
-		retv = (void *)nodev->data;
-		free(nodev);
-		nodev = NULL;
-		q->size -= 1;
-	}
-	return retv;
-}
-
-
-/**
-  Returns the element at the specified position in this list, or NULL if
-  the queue does not contain an index'th element.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param index position of retrieved element
-  @return the index'th element in the queue
-  @return NULL if the queue does not contain the index'th element
- */
-void *priqueue_at(priqueue_t *q, int index)
-{
-	node * retv;
-	if (q->front == NULL || index > priqueue_size(q)){
-		retv = NULL;
-	} else {
-		node * n = q->front;
-		int i = 0;
-		while(i != index) {
-			n = (node *)n->next;
-			i += 1;
-		}
-		retv = n;
-	}
-	return (retv == NULL)? NULL : retv->data;
-}
-
-
-/**
-  Removes all instances of ptr from the queue.
-
-  This function should not use the comparer function, but check if the data contained in each element of the queue is equal (==) to ptr.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param ptr address of element to be removed
-  @return the number of entries removed
- */
-int priqueue_remove(priqueue_t *q, void *ptr)
-{
-	int retv = 0;
-	if(q->front == NULL)
-	{
-		retv = 0;
-	} else {
-		node * cur_node = q->front;
-		node * pre_node = q->front;
-		while (cur_node != NULL) {
-			if(cur_node->data == ptr) {
-				if (cur_node == q->front){
-					q->front = q->front->next;
-					free(cur_node);
-					cur_node = q->front;
-					pre_node = q->front;
-				} else {
-					pre_node->next = cur_node->next;
-					free(cur_node);
-					cur_node = NULL;
-					cur_node = pre_node->next;
-				}
-				retv += 1;
-				q->size -= 1;
-			} else {
-				pre_node = cur_node;
-				cur_node = cur_node->next;
-			}
-		}
-	}
-	return retv;
-}
-
-
-/**
-  Removes the specified index from the queue, moving later elements up
-  a spot in the queue to fill the gap.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @param index position of element to be removed
-  @return the element removed from the queue
-  @return NULL if the specified index does not exist
- */
-void *priqueue_remove_at(priqueue_t *q, int index)
-{
-	node retv;
-	if(q->front == NULL || index > priqueue_size(q))
-	{
-		retv.data = NULL;
-	} else if (q->front->next == NULL && index == 0){
-		retv = *q->front;
-		q->size -= 1;
-	} else {
-		node * cur_node = q->front;
-		node * pre_node = q->front;
-		for (int i = 0; i < index; i++){
-			pre_node = cur_node;
-			cur_node = (node *)cur_node->next;
-		}
-		pre_node->next = cur_node->next;
-		cur_node->next = NULL;
-		retv = *cur_node;
-		q->size -= 1;
-	}
-	return retv.data;
-}
-
-
-/**
-  Returns the number of elements in the queue.
-
-  @param q a pointer to an instance of the priqueue_t data structure
-  @return the number of elements in the queue
- */
-int priqueue_size(priqueue_t *q)
-{
-	return q->size;
-}
-
-
-/**
-  Destroys and frees all the memory associated with q.
-
-  @param q a pointer to an instance of the priqueue_t data structure
- */
-void priqueue_destroy(priqueue_t *q)
-{
-	if(priqueue_size(q) != 0) {
-		node * cur_node = q->front;
-		node * pre_node = q->front;
-		while(cur_node != NULL) {
-			cur_node = cur_node->next;
-			free(pre_node);
-			pre_node = cur_node;
-		}
-		q->front = NULL;
-	}
-}
+/** @file libpriqueue.c
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libpriqueue.h"
+
+
+/*
+  Sorted linked list backend (PRIQUEUE_LIST)
+
+  Nodes come from a per-queue pool instead of malloc. The pool grows a
+  chunk at a time, doubling the number of nodes it owns, keeps released
+  nodes on a free list and is freed in bulk by priqueue_destroy().
+*/
+
+#define NODE_CHUNK_MIN 32
+
+static void node_pool_grow(priqueue_t *q, int count)
+{
+	node_chunk * chunk = malloc(sizeof(node_chunk) + sizeof(node) * count);
+	chunk->count = count;
+	chunk->next = q->chunks;
+	q->chunks = chunk;
+	for (int i = 0; i < count; i++) {
+		chunk->nodes[i].next = q->free_nodes;
+		q->free_nodes = &chunk->nodes[i];
+	}
+	q->pooled += count;
+}
+
+static node * node_alloc(priqueue_t *q)
+{
+	if (q->free_nodes == NULL)
+		node_pool_grow(q, (q->pooled < NODE_CHUNK_MIN) ? NODE_CHUNK_MIN : q->pooled);
+	node * n = q->free_nodes;
+	q->free_nodes = n->next;
+	return n;
+}
+
+static void node_release(priqueue_t *q, node *n)
+{
+	n->next = q->free_nodes;
+	q->free_nodes = n;
+}
+
+static int list_offer(priqueue_t *q, void *ptr)
+{
+	//node a;
+	node * new_node = node_alloc(q);
+	//node_t* newNode
+	new_node->data = ptr;
+	new_node->next = NULL;
+	int retv = 0;
+	// if its the first job, make it front
+	if (q->size == 0){
+		q->front = new_node;
+	} else {
+		node * cur_node = q->front;
+		node * pre_node = q->front;
+		while(cur_node != NULL) {
+			// If we get a negative then new_node is less than cur_node
+			if(q->cmp(new_node->data, cur_node->data) < 0){
+				// If its the first node, we need a special case
+				if (cur_node == q->front){
+					q->front = new_node;
+					new_node->next = cur_node;
+				} else {
+					pre_node->next = new_node;
+					new_node->next = cur_node;
+				}
+				break;
+			}
+			// iterate the nodes
+			pre_node = cur_node;
+			cur_node = cur_node->next;
+			retv++;
+		}
+		// cmp never returned -1, so were at the end of the queue and need to have a special case
+		if (cur_node == NULL){
+			pre_node->next = new_node;
+		}
+	}
+	q->size += 1;
+	return retv;
+}
+
+static void * list_poll(priqueue_t *q)
+{
+	node * nodev = NULL;
+	void * retv = NULL;
+	if (q->front == NULL) {
+		return NULL;
+	} else {
+		//
+		nodev = q->front;
+		q->front = nodev->next;
+		retv = (void *)nodev->data;
+		node_release(q, nodev);
+		nodev = NULL;
+		q->size -= 1;
+	}
+	return retv;
+}
+
+static void * list_at(priqueue_t *q, int index)
+{
+	node * retv;
+	if (q->front == NULL || index > priqueue_size(q)){
+		retv = NULL;
+	} else {
+		node * n = q->front;
+		int i = 0;
+		while(i != index) {
+			n = (node *)n->next;
+			i += 1;
+		}
+		retv = n;
+	}
+	return (retv == NULL)? NULL : retv->data;
+}
+
+static int list_remove(priqueue_t *q, void *ptr)
+{
+	int retv = 0;
+	if(q->front == NULL)
+	{
+		retv = 0;
+	} else {
+		node * cur_node = q->front;
+		node * pre_node = q->front;
+		while (cur_node != NULL) {
+			if(cur_node->data == ptr) {
+				if (cur_node == q->front){
+					q->front = q->front->next;
+					node_release(q, cur_node);
+					cur_node = q->front;
+					pre_node = q->front;
+				} else {
+					pre_node->next = cur_node->next;
+					node_release(q, cur_node);
+					cur_node = NULL;
+					cur_node = pre_node->next;
+				}
+				retv += 1;
+				q->size -= 1;
+			} else {
+				pre_node = cur_node;
+				cur_node = cur_node->next;
+			}
+		}
+	}
+	return retv;
+}
+
+static void * list_remove_at(priqueue_t *q, int index)
+{
+	void * retv;
+	if(q->front == NULL || index >= priqueue_size(q))
+	{
+		retv = NULL;
+	} else if (index == 0){
+		node * old_front = q->front;
+		q->front = old_front->next;
+		retv = old_front->data;
+		node_release(q, old_front);
+		q->size -= 1;
+	} else {
+		node * cur_node = q->front;
+		node * pre_node = q->front;
+		for (int i = 0; i < index; i++){
+			pre_node = cur_node;
+			cur_node = (node *)cur_node->next;
+		}
+		pre_node->next = cur_node->next;
+		retv = cur_node->data;
+		node_release(q, cur_node);
+		q->size -= 1;
+	}
+	return retv;
+}
+
+// Stable bottom-up merge sort of n element pointers, using tmp as scratch
+static void list_sort(comparer cmp, void **a, void **tmp, int n)
+{
+	for (int width = 1; width < n; width *= 2) {
+		for (int lo = 0; lo < n; lo += 2 * width) {
+			int mid = (lo + width < n) ? lo + width : n;
+			int hi = (lo + 2 * width < n) ? lo + 2 * width : n;
+			int i = lo, j = mid, k = lo;
+			while (i < mid && j < hi)
+				tmp[k++] = (cmp(a[j], a[i]) < 0) ? a[j++] : a[i++];
+			while (i < mid)
+				tmp[k++] = a[i++];
+			while (j < hi)
+				tmp[k++] = a[j++];
+		}
+		memcpy(a, tmp, sizeof(void *) * n);
+	}
+}
+
+// Sorts the batch and merges it into the list in one walk. Equal elements
+// land behind the ones already queued and keep their array order, as they
+// would if offered one by one.
+static int list_offer_batch(priqueue_t *q, void **ptrs, int n)
+{
+	void ** sorted = malloc(sizeof(void *) * 2 * n);
+	memcpy(sorted, ptrs, sizeof(void *) * n);
+	list_sort(q->cmp, sorted, sorted + n, n);
+
+	node ** link = &q->front;
+	for (int i = 0; i < n; i++) {
+		while (*link != NULL && q->cmp(sorted[i], (*link)->data) >= 0)
+			link = &(*link)->next;
+		node * new_node = node_alloc(q);
+		new_node->data = sorted[i];
+		new_node->next = *link;
+		*link = new_node;
+		link = &new_node->next;
+	}
+	free(sorted);
+	q->size += n;
+	return n;
+}
+
+static void list_destroy(priqueue_t *q)
+{
+	// every node lives in a chunk, so releasing the chunks frees the list too
+	while (q->chunks != NULL) {
+		node_chunk * chunk = q->chunks;
+		q->chunks = chunk->next;
+		free(chunk);
+	}
+	q->front = NULL;
+	q->free_nodes = NULL;
+	q->pooled = 0;
+	q->size = 0;
+}
+
+
+/*
+  d-ary heap backend (PRIQUEUE_HEAP)
+
+  Entries live in one contiguous array. Every entry carries the sequence
+  number it was offered with, and ties under the comparer are broken by
+  that number, so equal elements leave the heap in the same order the
+  sorted list would hand them out.
+
+  Every entry also owns a handle, an index into slot_of that follows the
+  entry as it moves, so handles can be removed or re-sifted in O(log n).
+  Handles of departed entries are recycled through the free_handles stack.
+*/
+
+static int heap_before(comparer cmp, heap_entry *a, heap_entry *b)
+{
+	int c = cmp(a->data, b->data);
+	return c < 0 || (c == 0 && a->seq < b->seq);
+}
+
+// slot_of may be NULL when sifting a scratch copy that has no handles to track
+static int heap_sift_up(comparer cmp, heap_entry *heap, int *slot_of, int i)
+{
+	heap_entry e = heap[i];
+	while (i > 0) {
+		int parent = (i - 1) / PRIQUEUE_HEAP_ARITY;
+		if (!heap_before(cmp, &e, &heap[parent]))
+			break;
+		heap[i] = heap[parent];
+		if (slot_of != NULL)
+			slot_of[heap[i].handle] = i;
+		i = parent;
+	}
+	heap[i] = e;
+	if (slot_of != NULL)
+		slot_of[e.handle] = i;
+	return i;
+}
+
+static int heap_sift_down(comparer cmp, heap_entry *heap, int *slot_of, int n, int i)
+{
+	heap_entry e = heap[i];
+	while (1) {
+		int first = i * PRIQUEUE_HEAP_ARITY + 1;
+		if (first >= n)
+			break;
+		int last = first + PRIQUEUE_HEAP_ARITY;
+		if (last > n)
+			last = n;
+		// find the best child
+		int best = first;
+		for (int c = first + 1; c < last; c++) {
+			if (heap_before(cmp, &heap[c], &heap[best]))
+				best = c;
+		}
+		if (!heap_before(cmp, &heap[best], &e))
+			break;
+		heap[i] = heap[best];
+		if (slot_of != NULL)
+			slot_of[heap[i].handle] = i;
+		i = best;
+	}
+	heap[i] = e;
+	if (slot_of != NULL)
+		slot_of[e.handle] = i;
+	return i;
+}
+
+// Moves the entry in slot i to wherever its current key belongs
+static int heap_resift(priqueue_t *q, int i)
+{
+	i = heap_sift_up(q->cmp, q->heap, q->slot_of, i);
+	return heap_sift_down(q->cmp, q->heap, q->slot_of, q->size, i);
+}
+
+// Removes the entry in slot i, filling the hole with the last entry
+static void * heap_delete_slot(priqueue_t *q, int i)
+{
+	void * retv = q->heap[i].data;
+	q->free_handles[q->capacity - q->size] = q->heap[i].handle;
+	q->slot_of[q->heap[i].handle] = -1;
+	q->size -= 1;
+	if (i != q->size) {
+		q->heap[i] = q->heap[q->size];
+		heap_resift(q, i);
+	}
+	return retv;
+}
+
+// Finds the entry at position index in priority order by popping a scratch copy
+static int heap_slot_of_rank(priqueue_t *q, int index)
+{
+	if (index == 0)
+		return 0;
+
+	heap_entry * scratch = malloc(sizeof(heap_entry) * q->size);
+	memcpy(scratch, q->heap, sizeof(heap_entry) * q->size);
+	int n = q->size;
+	for (int i = 0; i < index; i++) {
+		n -= 1;
+		scratch[0] = scratch[n];
+		heap_sift_down(q->cmp, scratch, NULL, n, 0);
+	}
+	int handle = scratch[0].handle;
+	free(scratch);
+	return q->slot_of[handle];
+}
+
+static void heap_grow(priqueue_t *q)
+{
+	int old_capacity = q->capacity;
+	q->capacity = (old_capacity == 0) ? 16 : old_capacity * 2;
+	q->heap = realloc(q->heap, sizeof(heap_entry) * q->capacity);
+	q->slot_of = realloc(q->slot_of, sizeof(int) * q->capacity);
+	q->free_handles = realloc(q->free_handles, sizeof(int) * q->capacity);
+
+	// slide any free handles up and slip the new ones in beneath them, so low ids come out first
+	int added = q->capacity - old_capacity;
+	memmove(q->free_handles + added, q->free_handles, sizeof(int) * (old_capacity - q->size));
+	for (int i = 0; i < added; i++) {
+		q->free_handles[i] = q->capacity - 1 - i;
+		q->slot_of[q->capacity - 1 - i] = -1;
+	}
+}
+
+static int heap_offer_handle(priqueue_t *q, void *ptr, int *slot)
+{
+	if (q->size == q->capacity)
+		heap_grow(q);
+	int i = q->size;
+	// capacity - size handles are free, the top one sits just below that
+	int handle = q->free_handles[q->capacity - q->size - 1];
+	q->heap[i].data = ptr;
+	q->heap[i].seq = q->seq++;
+	q->heap[i].handle = handle;
+	q->size += 1;
+	*slot = heap_sift_up(q->cmp, q->heap, q->slot_of, i);
+	return handle;
+}
+
+static int heap_offer(priqueue_t *q, void *ptr)
+{
+	int slot;
+	heap_offer_handle(q, ptr, &slot);
+	// report the slot the element landed in; 0 means it is now the head
+	return slot;
+}
+
+// Appends the batch and restores the heap bottom-up when it outnumbers the
+// entries already there, or sifts each one up otherwise
+static int heap_offer_batch(priqueue_t *q, void **ptrs, int n)
+{
+	int old_size = q->size;
+	while (q->capacity < old_size + n)
+		heap_grow(q);
+	for (int i = 0; i < n; i++) {
+		int handle = q->free_handles[q->capacity - q->size - 1];
+		q->heap[q->size].data = ptrs[i];
+		q->heap[q->size].seq = q->seq++;
+		q->heap[q->size].handle = handle;
+		q->slot_of[handle] = q->size;
+		q->size += 1;
+	}
+	if (n > old_size) {
+		for (int i = (q->size - 2) / PRIQUEUE_HEAP_ARITY; q->size > 1 && i >= 0; i--)
+			heap_sift_down(q->cmp, q->heap, q->slot_of, q->size, i);
+	} else {
+		for (int i = old_size; i < q->size; i++)
+			heap_sift_up(q->cmp, q->heap, q->slot_of, i);
+	}
+	return n;
+}
+
+static void * heap_poll(priqueue_t *q)
+{
+	if (q->size == 0)
+		return NULL;
+	return heap_delete_slot(q, 0);
+}
+
+static void * heap_at(priqueue_t *q, int index)
+{
+	if (index < 0 || index >= q->size)
+		return NULL;
+	return q->heap[heap_slot_of_rank(q, index)].data;
+}
+
+static int heap_remove(priqueue_t *q, void *ptr)
+{
+	// compact the surviving entries, then restore the heap order in O(n)
+	int kept = 0;
+	for (int i = 0; i < q->size; i++) {
+		if (q->heap[i].data != ptr) {
+			q->heap[kept] = q->heap[i];
+			q->slot_of[q->heap[kept].handle] = kept;
+			kept++;
+		} else {
+			q->free_handles[q->capacity - q->size + (i - kept)] = q->heap[i].handle;
+			q->slot_of[q->heap[i].handle] = -1;
+		}
+	}
+	int retv = q->size - kept;
+	q->size = kept;
+	if (retv > 0 && kept > 1) {
+		for (int i = (kept - 2) / PRIQUEUE_HEAP_ARITY; i >= 0; i--)
+			heap_sift_down(q->cmp, q->heap, q->slot_of, kept, i);
+	}
+	return retv;
+}
+
+static void * heap_remove_at(priqueue_t *q, int index)
+{
+	if (index < 0 || index >= q->size)
+		return NULL;
+	return heap_delete_slot(q, heap_slot_of_rank(q, index));
+}
+
+static void heap_destroy(priqueue_t *q)
+{
+	free(q->heap);
+	free(q->slot_of);
+	free(q->free_handles);
+	q->heap = NULL;
+	q->slot_of = NULL;
+	q->free_handles = NULL;
+	q->capacity = 0;
+	q->size = 0;
+}
+
+
+/*
+  FIFO ring buffers, used directly by PRIQUEUE_FIFO and once per level by
+  PRIQUEUE_BUCKET. The capacity is always a power of two so slots wrap
+  with a mask.
+*/
+
+#define FIFO_SLOT(f, i) ((f)->slots[((f)->head + (i)) & ((f)->capacity - 1)])
+
+static void fifo_init(fifo *f)
+{
+	f->slots = NULL;
+	f->head = 0;
+	f->size = 0;
+	f->capacity = 0;
+}
+
+static void fifo_grow(fifo *f)
+{
+	int new_capacity = (f->capacity == 0) ? 16 : f->capacity * 2;
+	void ** new_slots = malloc(sizeof(void *) * new_capacity);
+	// unwrap the old contents to the start of the new buffer
+	for (int i = 0; i < f->size; i++)
+		new_slots[i] = FIFO_SLOT(f, i);
+	free(f->slots);
+	f->slots = new_slots;
+	f->head = 0;
+	f->capacity = new_capacity;
+}
+
+static int fifo_push(fifo *f, void *ptr)
+{
+	if (f->size == f->capacity)
+		fifo_grow(f);
+	FIFO_SLOT(f, f->size) = ptr;
+	f->size += 1;
+	return f->size - 1;
+}
+
+static void * fifo_pop(fifo *f)
+{
+	if (f->size == 0)
+		return NULL;
+	void * retv = f->slots[f->head];
+	f->head = (f->head + 1) & (f->capacity - 1);
+	f->size -= 1;
+	return retv;
+}
+
+static void * fifo_at(fifo *f, int index)
+{
+	if (index < 0 || index >= f->size)
+		return NULL;
+	return FIFO_SLOT(f, index);
+}
+
+static int fifo_remove(fifo *f, void *ptr)
+{
+	int kept = 0;
+	for (int i = 0; i < f->size; i++) {
+		void * data = FIFO_SLOT(f, i);
+		if (data != ptr)
+			FIFO_SLOT(f, kept++) = data;
+	}
+	int retv = f->size - kept;
+	f->size = kept;
+	return retv;
+}
+
+static void * fifo_remove_at(fifo *f, int index)
+{
+	if (index < 0 || index >= f->size)
+		return NULL;
+	void * retv = FIFO_SLOT(f, index);
+	// close the gap from whichever end is nearer
+	if (index < f->size / 2) {
+		for (int i = index; i > 0; i--)
+			FIFO_SLOT(f, i) = FIFO_SLOT(f, i - 1);
+		f->head = (f->head + 1) & (f->capacity - 1);
+	} else {
+		for (int i = index; i < f->size - 1; i++)
+			FIFO_SLOT(f, i) = FIFO_SLOT(f, i + 1);
+	}
+	f->size -= 1;
+	return retv;
+}
+
+static void fifo_destroy(fifo *f)
+{
+	free(f->slots);
+	fifo_init(f);
+}
+
+static int ring_offer(priqueue_t *q, void *ptr)
+{
+	q->size += 1;
+	return fifo_push(&q->ring, ptr);
+}
+
+static int ring_offer_batch(priqueue_t *q, void **ptrs, int n)
+{
+	while (q->ring.capacity < q->ring.size + n)
+		fifo_grow(&q->ring);
+	for (int i = 0; i < n; i++)
+		FIFO_SLOT(&q->ring, q->ring.size + i) = ptrs[i];
+	q->ring.size += n;
+	q->size += n;
+	return n;
+}
+
+static void * ring_poll(priqueue_t *q)
+{
+	void * retv = fifo_pop(&q->ring);
+	q->size = q->ring.size;
+	return retv;
+}
+
+static void * ring_at(priqueue_t *q, int index)
+{
+	return fifo_at(&q->ring, index);
+}
+
+static int ring_remove(priqueue_t *q, void *ptr)
+{
+	int retv = fifo_remove(&q->ring, ptr);
+	q->size = q->ring.size;
+	return retv;
+}
+
+static void * ring_remove_at(priqueue_t *q, int index)
+{
+	void * retv = fifo_remove_at(&q->ring, index);
+	q->size = q->ring.size;
+	return retv;
+}
+
+static void ring_destroy(priqueue_t *q)
+{
+	fifo_destroy(&q->ring);
+	q->size = 0;
+}
+
+
+/*
+  Bucket queue backend (PRIQUEUE_BUCKET)
+
+  One FIFO per priority level plus a bitmap of the non-empty levels, so
+  the best level is found with a find-first-set. Elements of the same
+  level keep their offer order.
+*/
+
+#define BUCKET_WORD_BITS (8 * (int)sizeof(unsigned long))
+
+static void bucket_resize(priqueue_t *q, int levels)
+{
+	int old_words = (q->levels + BUCKET_WORD_BITS - 1) / BUCKET_WORD_BITS;
+	int new_words = (levels + BUCKET_WORD_BITS - 1) / BUCKET_WORD_BITS;
+
+	q->buckets = realloc(q->buckets, sizeof(fifo) * levels);
+	for (int i = q->levels; i < levels; i++)
+		fifo_init(&q->buckets[i]);
+
+	q->occupied = realloc(q->occupied, sizeof(unsigned long) * new_words);
+	for (int i = old_words; i < new_words; i++)
+		q->occupied[i] = 0;
+
+	q->levels = levels;
+}
+
+// Returns the lowest non-empty level, or -1 if every bucket is empty
+static int bucket_first(priqueue_t *q)
+{
+	int words = (q->levels + BUCKET_WORD_BITS - 1) / BUCKET_WORD_BITS;
+	for (int w = 0; w < words; w++) {
+		if (q->occupied[w] != 0)
+			return w * BUCKET_WORD_BITS + __builtin_ctzl(q->occupied[w]);
+	}
+	return -1;
+}
+
+static void bucket_mark(priqueue_t *q, int level)
+{
+	unsigned long bit = 1UL << (level % BUCKET_WORD_BITS);
+	if (q->buckets[level].size > 0)
+		q->occupied[level / BUCKET_WORD_BITS] |= bit;
+	else
+		q->occupied[level / BUCKET_WORD_BITS] &= ~bit;
+}
+
+// Finds the level holding position index in priority order and rebases index into it
+static int bucket_locate(priqueue_t *q, int *index)
+{
+	for (int level = 0; level < q->levels; level++) {
+		if (*index < q->buckets[level].size)
+			return level;
+		*index -= q->buckets[level].size;
+	}
+	return -1;
+}
+
+static int bucket_offer(priqueue_t *q, void *ptr)
+{
+	int level = q->key(ptr);
+	if (level < 0)
+		level = 0;
+	else if (level >= PRIQUEUE_BUCKET_MAX_LEVELS)
+		level = PRIQUEUE_BUCKET_MAX_LEVELS - 1;
+	if (level >= q->levels) {
+		int levels = q->levels;
+		while (level >= levels)
+			levels *= 2;
+		bucket_resize(q, (levels < PRIQUEUE_BUCKET_MAX_LEVELS) ? levels : PRIQUEUE_BUCKET_MAX_LEVELS);
+	}
+	// 0 only when ptr became the front, like the heap
+	int first = bucket_first(q);
+	int retv = (first != -1 && first < level) ? 1 : 0;
+	retv += fifo_push(&q->buckets[level], ptr);
+	bucket_mark(q, level);
+	q->size += 1;
+	return retv;
+}
+
+static void * bucket_peek(priqueue_t *q)
+{
+	int level = bucket_first(q);
+	return (level < 0) ? NULL : fifo_at(&q->buckets[level], 0);
+}
+
+static void * bucket_poll(priqueue_t *q)
+{
+	int level = bucket_first(q);
+	if (level < 0)
+		return NULL;
+	void * retv = fifo_pop(&q->buckets[level]);
+	bucket_mark(q, level);
+	q->size -= 1;
+	return retv;
+}
+
+static void * bucket_at(priqueue_t *q, int index)
+{
+	if (index < 0 || index >= q->size)
+		return NULL;
+	int level = bucket_locate(q, &index);
+	return fifo_at(&q->buckets[level], index);
+}
+
+static int bucket_remove(priqueue_t *q, void *ptr)
+{
+	int retv = 0;
+	for (int level = 0; level < q->levels; level++) {
+		if (q->buckets[level].size > 0) {
+			retv += fifo_remove(&q->buckets[level], ptr);
+			bucket_mark(q, level);
+		}
+	}
+	q->size -= retv;
+	return retv;
+}
+
+static void * bucket_remove_at(priqueue_t *q, int index)
+{
+	if (index < 0 || index >= q->size)
+		return NULL;
+	int level = bucket_locate(q, &index);
+	void * retv = fifo_remove_at(&q->buckets[level], index);
+	bucket_mark(q, level);
+	q->size -= 1;
+	return retv;
+}
+
+static void bucket_destroy(priqueue_t *q)
+{
+	for (int level = 0; level < q->levels; level++)
+		fifo_destroy(&q->buckets[level]);
+	free(q->buckets);
+	free(q->occupied);
+	q->buckets = NULL;
+	q->occupied = NULL;
+	q->levels = 0;
+	q->size = 0;
+}
+
+
+/*
+  Inline-keyed heap backend (PRIQUEUE_KEYED)
+
+  Same d-ary layout as PRIQUEUE_HEAP, but each entry packs its key and
+  sequence number into one 64-bit integer next to the data pointer, so
+  sifting is a plain integer compare with no comparer call and no
+  dereference of the elements. The key function runs once per offer.
+  Entries carry no handle, so priqueue_offer_handle() refuses keyed queues.
+*/
+
+// Flips the sign bit so signed keys order correctly as unsigned
+#define KEYED_PACK(key, seq) \
+	(((uint64_t)((uint32_t)(key) ^ 0x80000000u) << 32) | (uint32_t)(seq))
+
+// Sequence numbers are renumbered before they reach this, see keyed_reserve_seq()
+#define KEYED_SEQ_LIMIT ((uint64_t)UINT32_MAX)
+
+static int keyed_sift_up(keyed_entry *heap, int i)
+{
+	keyed_entry e = heap[i];
+	while (i > 0) {
+		int parent = (i - 1) / PRIQUEUE_HEAP_ARITY;
+		if (heap[parent].key <= e.key)
+			break;
+		heap[i] = heap[parent];
+		i = parent;
+	}
+	heap[i] = e;
+	return i;
+}
+
+static void keyed_sift_down(keyed_entry *heap, int n, int i)
+{
+	keyed_entry e = heap[i];
+	while (1) {
+		int first = i * PRIQUEUE_HEAP_ARITY + 1;
+		if (first >= n)
+			break;
+		int last = first + PRIQUEUE_HEAP_ARITY;
+		if (last > n)
+			last = n;
+		int best = first;
+		for (int c = first + 1; c < last; c++)
+			best = (heap[c].key < heap[best].key) ? c : best;
+		if (e.key <= heap[best].key)
+			break;
+		heap[i] = heap[best];
+		i = best;
+	}
+	heap[i] = e;
+}
+
+static void keyed_heapify(keyed_entry *heap, int n)
+{
+	for (int i = (n - 2) / PRIQUEUE_HEAP_ARITY; n > 1 && i >= 0; i--)
+		keyed_sift_down(heap, n, i);
+}
+
+static void keyed_grow(priqueue_t *q)
+{
+	q->capacity = (q->capacity == 0) ? 16 : q->capacity * 2;
+	q->keyed = realloc(q->keyed, sizeof(keyed_entry) * q->capacity);
+}
+
+static void * keyed_delete_slot(priqueue_t *q, int i)
+{
+	void * retv = q->keyed[i].data;
+	q->size -= 1;
+	if (i != q->size) {
+		q->keyed[i] = q->keyed[q->size];
+		i = keyed_sift_up(q->keyed, i);
+		keyed_sift_down(q->keyed, q->size, i);
+	}
+	return retv;
+}
+
+// Finds the entry at position index in priority order by popping a scratch copy
+static int keyed_slot_of_rank(priqueue_t *q, int index)
+{
+	if (index == 0)
+		return 0;
+
+	keyed_entry * scratch = malloc(sizeof(keyed_entry) * q->size);
+	memcpy(scratch, q->keyed, sizeof(keyed_entry) * q->size);
+	int n = q->size;
+	for (int i = 0; i < index; i++) {
+		n -= 1;
+		scratch[0] = scratch[n];
+		keyed_sift_down(scratch, n, 0);
+	}
+	uint64_t key = scratch[0].key;
+	free(scratch);
+
+	// packed keys carry the sequence number, so they identify the slot
+	for (int i = 0; i < q->size; i++) {
+		if (q->keyed[i].key == key)
+			return i;
+	}
+	return -1;
+}
+
+static int keyed_compare_packed(const void *a, const void *b)
+{
+	uint64_t x = ((const keyed_entry *)a)->key, y = ((const keyed_entry *)b)->key;
+	return (x > y) - (x < y);
+}
+
+/*
+  Makes room for n more sequence numbers. Once the counter would run past
+  32 bits, the live entries are sorted (which keeps ties in offer order and
+  leaves a valid heap) and renumbered from 0, so ties stay FIFO and packed
+  keys stay unique however many offers the queue has seen.
+*/
+static void keyed_reserve_seq(priqueue_t *q, int n)
+{
+	if ((uint64_t)q->seq + n < KEYED_SEQ_LIMIT)
+		return;
+	qsort(q->keyed, q->size, sizeof(keyed_entry), keyed_compare_packed);
+	for (int i = 0; i < q->size; i++)
+		q->keyed[i].key = (q->keyed[i].key & ~(uint64_t)UINT32_MAX) | (uint32_t)i;
+	q->seq = q->size;
+}
+
+static int keyed_offer_key(priqueue_t *q, void *ptr, int key)
+{
+	if (q->size == q->capacity)
+		keyed_grow(q);
+	keyed_reserve_seq(q, 1);
+	int i = q->size;
+	q->keyed[i].key = KEYED_PACK(key, q->seq++);
+	q->keyed[i].data = ptr;
+	q->size += 1;
+	return keyed_sift_up(q->keyed, i);
+}
+
+static int keyed_offer(priqueue_t *q, void *ptr)
+{
+	return keyed_offer_key(q, ptr, q->key(ptr));
+}
+
+// Same strategy as heap_offer_batch()
+static int keyed_offer_batch(priqueue_t *q, void **ptrs, int n)
+{
+	int old_size = q->size;
+	while (q->capacity < old_size + n)
+		keyed_grow(q);
+	keyed_reserve_seq(q, n);
+	for (int i = 0; i < n; i++) {
+		q->keyed[q->size].key = KEYED_PACK(q->key(ptrs[i]), q->seq++);
+		q->keyed[q->size].data = ptrs[i];
+		q->size += 1;
+	}
+	if (n > old_size) {
+		keyed_heapify(q->keyed, q->size);
+	} else {
+		for (int i = old_size; i < q->size; i++)
+			keyed_sift_up(q->keyed, i);
+	}
+	return n;
+}
+
+static void * keyed_poll(priqueue_t *q)
+{
+	if (q->size == 0)
+		return NULL;
+	return keyed_delete_slot(q, 0);
+}
+
+static void * keyed_at(priqueue_t *q, int index)
+{
+	if (index < 0 || index >= q->size)
+		return NULL;
+	return q->keyed[keyed_slot_of_rank(q, index)].data;
+}
+
+static int keyed_remove(priqueue_t *q, void *ptr)
+{
+	int kept = 0;
+	for (int i = 0; i < q->size; i++) {
+		if (q->keyed[i].data != ptr)
+			q->keyed[kept++] = q->keyed[i];
+	}
+	int retv = q->size - kept;
+	q->size = kept;
+	if (retv > 0)
+		keyed_heapify(q->keyed, kept);
+	return retv;
+}
+
+static void * keyed_remove_at(priqueue_t *q, int index)
+{
+	if (index < 0 || index >= q->size)
+		return NULL;
+	return keyed_delete_slot(q, keyed_slot_of_rank(q, index));
+}
+
+static void keyed_destroy(priqueue_t *q)
+{
+	free(q->keyed);
+	q->keyed = NULL;
+	q->capacity = 0;
+	q->size = 0;
+}
+
+
+/*
+  Pairing heap backend (PRIQUEUE_PAIRING)
+
+  A heap-ordered tree where offer and merge are a single meld of two roots
+  and poll rebuilds the root's children with the usual two-pass pairing,
+  O(log n) amortized. Ties are broken by offer sequence number as in
+  PRIQUEUE_HEAP. Released nodes are kept on the spare list and pooled
+  counts every node the queue owns, live or spare.
+*/
+
+static int pairing_before(comparer cmp, pairing_node *a, pairing_node *b)
+{
+	int c = cmp(a->data, b->data);
+	return c < 0 || (c == 0 && a->seq < b->seq);
+}
+
+// Melds two detached trees, the loser becoming the winner's first child
+static pairing_node * pairing_meld(comparer cmp, pairing_node *a, pairing_node *b)
+{
+	if (a == NULL)
+		return b;
+	if (b == NULL)
+		return a;
+	if (pairing_before(cmp, b, a)) {
+		pairing_node * t = a;
+		a = b;
+		b = t;
+	}
+	b->prev = a;
+	b->sibling = a->child;
+	if (a->child != NULL)
+		a->child->prev = b;
+	a->child = b;
+	a->sibling = NULL;
+	a->prev = NULL;
+	return a;
+}
+
+// Two-pass pairing of a sibling list: meld neighbours left to right, then
+// fold the pairs right to left
+static pairing_node * pairing_combine(comparer cmp, pairing_node *first)
+{
+	pairing_node * pairs = NULL;
+	while (first != NULL) {
+		pairing_node * a = first;
+		pairing_node * b = a->sibling;
+		first = (b == NULL) ? NULL : b->sibling;
+		a->sibling = NULL;
+		if (b != NULL)
+			b->sibling = NULL;
+		pairing_node * m = pairing_meld(cmp, a, b);
+		m->sibling = pairs;
+		pairs = m;
+	}
+
+	pairing_node * root = NULL;
+	while (pairs != NULL) {
+		pairing_node * next = pairs->sibling;
+		pairs->sibling = NULL;
+		root = pairing_meld(cmp, root, pairs);
+		pairs = next;
+	}
+	if (root != NULL)
+		root->prev = NULL;
+	return root;
+}
+
+static pairing_node * pairing_alloc(priqueue_t *q)
+{
+	pairing_node * n = q->spare;
+	if (n == NULL) {
+		n = malloc(sizeof(pairing_node));
+		q->pooled += 1;
+	} else {
+		q->spare = n->sibling;
+	}
+	return n;
+}
+
+static void pairing_release(priqueue_t *q, pairing_node *n)
+{
+	n->sibling = q->spare;
+	q->spare = n;
+}
+
+// Lists every node of the tree into out, which must hold q->size entries
+static void pairing_collect(priqueue_t *q, pairing_node **out)
+{
+	int count = 0;
+	if (q->root != NULL)
+		out[count++] = q->root;
+	for (int i = 0; i < count; i++) {
+		if (out[i]->child != NULL)
+			out[count++] = out[i]->child;
+		if (out[i]->sibling != NULL)
+			out[count++] = out[i]->sibling;
+	}
+}
+
+// Every node in priority order, for the positional calls and cursors; the caller frees it
+static pairing_node ** pairing_sorted(priqueue_t *q)
+{
+	pairing_node ** a = malloc(sizeof(pairing_node *) * 2 * (q->size + 1));
+	pairing_node ** tmp = a + q->size + 1;
+	int n = q->size;
+	pairing_collect(q, a);
+	for (int width = 1; width < n; width *= 2) {
+		for (int lo = 0; lo < n; lo += 2 * width) {
+			int mid = (lo + width < n) ? lo + width : n;
+			int hi = (lo + 2 * width < n) ? lo + 2 * width : n;
+			int i = lo, j = mid, k = lo;
+			while (i < mid && j < hi)
+				tmp[k++] = pairing_before(q->cmp, a[j], a[i]) ? a[j++] : a[i++];
+			while (i < mid)
+				tmp[k++] = a[i++];
+			while (j < hi)
+				tmp[k++] = a[j++];
+		}
+		memcpy(a, tmp, sizeof(pairing_node *) * n);
+	}
+	return a;
+}
+
+// Cuts n and its subtree out of the heap, then melds its children back in
+static void * pairing_remove_node(priqueue_t *q, pairing_node *n)
+{
+	void * retv = n->data;
+	if (n == q->root) {
+		q->root = pairing_combine(q->cmp, n->child);
+	} else {
+		if (n->prev->child == n)
+			n->prev->child = n->sibling;
+		else
+			n->prev->sibling = n->sibling;
+		if (n->sibling != NULL)
+			n->sibling->prev = n->prev;
+		n->sibling = NULL;
+		q->root = pairing_meld(q->cmp, q->root, pairing_combine(q->cmp, n->child));
+	}
+	pairing_release(q, n);
+	q->size -= 1;
+	return retv;
+}
+
+static int pairing_offer(priqueue_t *q, void *ptr)
+{
+	pairing_node * n = pairing_alloc(q);
+	n->data = ptr;
+	n->seq = q->seq++;
+	n->child = NULL;
+	n->sibling = NULL;
+	n->prev = NULL;
+	q->root = pairing_meld(q->cmp, q->root, n);
+	q->size += 1;
+	// like the heap, 0 only when ptr became the front
+	return (q->root == n) ? 0 : 1;
+}
+
+static void * pairing_poll(priqueue_t *q)
+{
+	if (q->root == NULL)
+		return NULL;
+	return pairing_remove_node(q, q->root);
+}
+
+static void * pairing_at(priqueue_t *q, int index)
+{
+	if (index < 0 || index >= q->size)
+		return NULL;
+	if (index == 0)
+		return q->root->data;
+	pairing_node ** sorted = pairing_sorted(q);
+	void * retv = sorted[index]->data;
+	free(sorted);
+	return retv;
+}
+
+static int pairing_remove(priqueue_t *q, void *ptr)
+{
+	int retv = 0, n = q->size;
+	pairing_node ** nodes = malloc(sizeof(pairing_node *) * (n + 1));
+	pairing_collect(q, nodes);
+	for (int i = 0; i < n; i++) {
+		if (nodes[i]->data == ptr) {
+			pairing_remove_node(q, nodes[i]);
+			retv += 1;
+		}
+	}
+	free(nodes);
+	return retv;
+}
+
+static void * pairing_remove_at(priqueue_t *q, int index)
+{
+	if (index < 0 || index >= q->size)
+		return NULL;
+	if (index == 0)
+		return pairing_poll(q);
+	pairing_node ** sorted = pairing_sorted(q);
+	void * retv = pairing_remove_node(q, sorted[index]);
+	free(sorted);
+	return retv;
+}
+
+// Moves every element of src into dst with one meld
+static void pairing_merge(priqueue_t *dst, priqueue_t *src)
+{
+	dst->root = pairing_meld(dst->cmp, dst->root, src->root);
+	dst->size += src->size;
+	dst->pooled += src->size;
+	src->pooled -= src->size;
+	// later offers to dst still sort behind every element it now holds
+	if (dst->seq < src->seq)
+		dst->seq = src->seq;
+	src->root = NULL;
+	src->size = 0;
+}
+
+static void pairing_destroy(priqueue_t *q)
+{
+	// flatten the tree into one list through sibling, freeing as it goes
+	pairing_node * todo = q->root;
+	while (todo != NULL) {
+		pairing_node * n = todo;
+		todo = n->sibling;
+		if (n->child != NULL) {
+			pairing_node * last = n->child;
+			while (last->sibling != NULL)
+				last = last->sibling;
+			last->sibling = todo;
+			todo = n->child;
+		}
+		free(n);
+	}
+	while (q->spare != NULL) {
+		pairing_node * n = q->spare;
+		q->spare = n->sibling;
+		free(n);
+	}
+	q->root = NULL;
+	q->pooled = 0;
+	q->size = 0;
+}
+
+
+/**
+  Initializes the priqueue_t data structure.
+
+  Assumtions
+    - You may assume this function will only be called once per instance of priqueue_t
+    - You may assume this function will be the first function called using an instance of priqueue_t.
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param comparer a function pointer that compares two elements.
+  See also @ref comparer-page
+ */
+void priqueue_init(priqueue_t *q, int(*comp)(const void *, const void *))
+{
+	priqueue_init_kind(q, comp, PRIQUEUE_LIST);
+}
+
+
+/**
+  Initializes the priqueue_t data structure with a specific storage backend.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param comparer a function pointer that compares two elements.
+  @param kind the backend used to store the elements
+  See also @ref comparer-page
+ */
+void priqueue_init_kind(priqueue_t *q, int(*comp)(const void *, const void *), priqueue_kind_t kind)
+{
+	q->front = NULL;
+	q->free_nodes = NULL;
+	q->chunks = NULL;
+	q->pooled = 0;
+	q->cmp = comp;
+	q->size = 0;
+	q->kind = kind;
+	q->heap = NULL;
+	q->slot_of = NULL;
+	q->free_handles = NULL;
+	q->keyed = NULL;
+	q->capacity = 0;
+	q->seq = 0;
+	fifo_init(&q->ring);
+	q->key = NULL;
+	q->buckets = NULL;
+	q->occupied = NULL;
+	q->levels = 0;
+	q->root = NULL;
+	q->spare = NULL;
+}
+
+
+/**
+  Initializes the priqueue_t data structure and fills it from an array in
+  one step, heapifying in O(n) rather than offering each element.
+
+  PRIQUEUE_BUCKET and PRIQUEUE_KEYED queues need a key function; set those
+  up with priqueue_init_buckets() or priqueue_init_keyed() and fill them
+  with priqueue_offer_batch(), which builds an empty queue the same way.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param comparer a function pointer that compares two elements.
+  @param kind the backend used to store the elements
+  @param ptrs the initial elements; ties keep their array order
+  @param n the number of elements in ptrs
+ */
+void priqueue_init_from_array(priqueue_t *q, int(*comp)(const void *, const void *), priqueue_kind_t kind, void **ptrs, int n)
+{
+	priqueue_init_kind(q, comp, kind);
+	priqueue_offer_batch(q, ptrs, n);
+}
+
+
+/**
+  Initializes the priqueue_t data structure as a bucket queue
+  (PRIQUEUE_BUCKET).
+
+  Elements are ordered by the level key() returns for them and keep their
+  offer order within a level. The comparer is not used for ordering but
+  is kept for callers that compare elements themselves.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param comparer a function pointer that compares two elements.
+  @param key a function returning the priority level of an element, see priqueue_key
+  @param levels the expected number of levels; the queue grows if a larger level is offered
+ */
+void priqueue_init_buckets(priqueue_t *q, int(*comp)(const void *, const void *), priqueue_key key, int levels)
+{
+	priqueue_init_kind(q, comp, PRIQUEUE_BUCKET);
+	q->key = key;
+	if (levels > PRIQUEUE_BUCKET_MAX_LEVELS)
+		levels = PRIQUEUE_BUCKET_MAX_LEVELS;
+	bucket_resize(q, (levels > 0) ? levels : 1);
+}
+
+
+/**
+  Initializes the priqueue_t data structure as an inline-keyed heap
+  (PRIQUEUE_KEYED).
+
+  Elements are ordered by the integer key() returns for them when they
+  are offered, ties going to the element offered first. Keys are
+  captured at offer time, so changing an element's fields afterwards does
+  not move it. The comparer is not used for ordering but is kept for
+  callers that compare elements themselves.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param comparer a function pointer that compares two elements.
+  @param key a function returning the key of an element, or NULL if every
+  element is offered through priqueue_offer_keyed()
+ */
+void priqueue_init_keyed(priqueue_t *q, int(*comp)(const void *, const void *), priqueue_key key)
+{
+	priqueue_init_kind(q, comp, PRIQUEUE_KEYED);
+	q->key = key;
+}
+
+
+/**
+  Inserts the specified element into this priority queue.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param ptr a pointer to the data to be inserted into the priority queue
+  @return The zero-based index where ptr is stored in the priority queue, where 0 indicates that ptr was stored at the front of the priority queue.
+  For PRIQUEUE_HEAP, PRIQUEUE_BUCKET, PRIQUEUE_KEYED and PRIQUEUE_PAIRING the value is only exact when it is 0, meaning ptr became the front.
+ */
+int priqueue_offer(priqueue_t *q, void *ptr)
+{
+	switch (q->kind) {
+		case PRIQUEUE_HEAP:
+			return heap_offer(q, ptr);
+		case PRIQUEUE_FIFO:
+			return ring_offer(q, ptr);
+		case PRIQUEUE_BUCKET:
+			return bucket_offer(q, ptr);
+		case PRIQUEUE_KEYED:
+			return keyed_offer(q, ptr);
+		case PRIQUEUE_PAIRING:
+			return pairing_offer(q, ptr);
+		default:
+			return list_offer(q, ptr);
+	}
+}
+
+
+/**
+  Inserts n elements at once, with the same result as passing each of them
+  to priqueue_offer() in array order. The heaps append the whole batch and
+  re-heapify bottom-up in O(size) when it outnumbers the elements already
+  queued; the list sorts the batch and merges it in a single walk.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param ptrs the elements to insert
+  @param n the number of elements in ptrs
+  @return the number of elements inserted
+ */
+int priqueue_offer_batch(priqueue_t *q, void **ptrs, int n)
+{
+	if (n <= 0)
+		return 0;
+	switch (q->kind) {
+		case PRIQUEUE_HEAP:
+			return heap_offer_batch(q, ptrs, n);
+		case PRIQUEUE_FIFO:
+			return ring_offer_batch(q, ptrs, n);
+		case PRIQUEUE_BUCKET:
+			for (int i = 0; i < n; i++)
+				bucket_offer(q, ptrs[i]);
+			return n;
+		case PRIQUEUE_KEYED:
+			return keyed_offer_batch(q, ptrs, n);
+		case PRIQUEUE_PAIRING:
+			for (int i = 0; i < n; i++)
+				pairing_offer(q, ptrs[i]);
+			return n;
+		default:
+			return list_offer_batch(q, ptrs, n);
+	}
+}
+
+/**
+  Retrieves, but does not remove, the head of this queue, returning NULL if
+  this queue is empty.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @return pointer to element at the head of the queue
+  @return NULL if the queue is empty
+ */
+void *priqueue_peek(priqueue_t *q)
+{
+	switch (q->kind) {
+		case PRIQUEUE_HEAP:
+			return (q->size == 0) ? NULL : q->heap[0].data;
+		case PRIQUEUE_FIFO:
+			return fifo_at(&q->ring, 0);
+		case PRIQUEUE_BUCKET:
+			return bucket_peek(q);
+		case PRIQUEUE_KEYED:
+			return (q->size == 0) ? NULL : q->keyed[0].data;
+		case PRIQUEUE_PAIRING:
+			return (q->root == NULL) ? NULL : q->root->data;
+		default:
+			return (q->front == NULL) ? NULL : q->front->data;
+	}
+}
+
+
+/**
+  Retrieves and removes the head of this queue, or NULL if this queue
+  is empty.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @return the head of this queue
+  @return NULL if this queue is empty
+ */
+void * priqueue_poll(priqueue_t *q)
+{
+	switch (q->kind) {
+		case PRIQUEUE_HEAP:
+			return heap_poll(q);
+		case PRIQUEUE_FIFO:
+			return ring_poll(q);
+		case PRIQUEUE_BUCKET:
+			return bucket_poll(q);
+		case PRIQUEUE_KEYED:
+			return keyed_poll(q);
+		case PRIQUEUE_PAIRING:
+			return pairing_poll(q);
+		default:
+			return list_poll(q);
+	}
+}
+
+
+/**
+  Returns the element at the specified position in this list, or NULL if
+  the queue does not contain an index'th element.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param index position of retrieved element
+  @return the index'th element in the queue
+  @return NULL if the queue does not contain the index'th element
+ */
+void *priqueue_at(priqueue_t *q, int index)
+{
+	switch (q->kind) {
+		case PRIQUEUE_HEAP:
+			return heap_at(q, index);
+		case PRIQUEUE_FIFO:
+			return ring_at(q, index);
+		case PRIQUEUE_BUCKET:
+			return bucket_at(q, index);
+		case PRIQUEUE_KEYED:
+			return keyed_at(q, index);
+		case PRIQUEUE_PAIRING:
+			return pairing_at(q, index);
+		default:
+			return list_at(q, index);
+	}
+}
+
+
+/**
+  Removes all instances of ptr from the queue.
+
+  This function should not use the comparer function, but check if the data contained in each element of the queue is equal (==) to ptr.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param ptr address of element to be removed
+  @return the number of entries removed
+ */
+int priqueue_remove(priqueue_t *q, void *ptr)
+{
+	switch (q->kind) {
+		case PRIQUEUE_HEAP:
+			return heap_remove(q, ptr);
+		case PRIQUEUE_FIFO:
+			return ring_remove(q, ptr);
+		case PRIQUEUE_BUCKET:
+			return bucket_remove(q, ptr);
+		case PRIQUEUE_KEYED:
+			return keyed_remove(q, ptr);
+		case PRIQUEUE_PAIRING:
+			return pairing_remove(q, ptr);
+		default:
+			return list_remove(q, ptr);
+	}
+}
+
+
+/**
+  Removes the specified index from the queue, moving later elements up
+  a spot in the queue to fill the gap.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param index position of element to be removed
+  @return the element removed from the queue
+  @return NULL if the specified index does not exist
+ */
+void *priqueue_remove_at(priqueue_t *q, int index)
+{
+	switch (q->kind) {
+		case PRIQUEUE_HEAP:
+			return heap_remove_at(q, index);
+		case PRIQUEUE_FIFO:
+			return ring_remove_at(q, index);
+		case PRIQUEUE_BUCKET:
+			return bucket_remove_at(q, index);
+		case PRIQUEUE_KEYED:
+			return keyed_remove_at(q, index);
+		case PRIQUEUE_PAIRING:
+			return pairing_remove_at(q, index);
+		default:
+			return list_remove_at(q, index);
+	}
+}
+
+
+/**
+  Inserts the specified element and returns a handle to it.
+
+  The handle stays valid until the element leaves the queue and can be
+  passed to priqueue_remove_handle() and priqueue_update_key(). Only
+  PRIQUEUE_HEAP queues issue handles. Other backends refuse the call and
+  leave the queue unchanged, so a caller that ignores the -1 loses the
+  element rather than getting a queue that quietly lacks handles. In
+  particular PRIQUEUE_KEYED has none: its entries stay two words so that
+  sifting never touches a handle table. Code that needs to reposition
+  elements of a keyed order can use PRIQUEUE_DEFINE_INDEXED from
+  libpriqueue_typed.h, as the scheduler's victim heaps do.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param ptr a pointer to the data to be inserted into the priority queue
+  @return a handle to the inserted element
+  @return -1 if q is not a PRIQUEUE_HEAP queue; ptr is not inserted
+ */
+int priqueue_offer_handle(priqueue_t *q, void *ptr)
+{
+	if (q->kind != PRIQUEUE_HEAP)
+		return -1;
+	int slot;
+	return heap_offer_handle(q, ptr, &slot);
+}
+
+
+/**
+  Inserts the specified element into a PRIQUEUE_KEYED queue under an
+  explicit key, skipping the queue's key function.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param ptr a pointer to the data to be inserted into the priority queue
+  @param key the key to order ptr by; lower keys are served first
+  @return 0 if ptr became the front of the queue, a positive value otherwise
+  @return -1 if q is not a PRIQUEUE_KEYED queue
+ */
+int priqueue_offer_keyed(priqueue_t *q, void *ptr, int key)
+{
+	if (q->kind != PRIQUEUE_KEYED)
+		return -1;
+	return keyed_offer_key(q, ptr, key);
+}
+
+
+/**
+  Removes the element a handle refers to in O(log n).
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param handle a handle returned by priqueue_offer_handle()
+  @return the element removed from the queue
+  @return NULL if the handle does not refer to an element in the queue,
+  or q is not a PRIQUEUE_HEAP queue
+ */
+void *priqueue_remove_handle(priqueue_t *q, int handle)
+{
+	if (q->kind != PRIQUEUE_HEAP || handle < 0 || handle >= q->capacity || q->slot_of[handle] < 0)
+		return NULL;
+	return heap_delete_slot(q, q->slot_of[handle]);
+}
+
+
+/**
+  Repositions the element a handle refers to after its key changed.
+
+  Call this after modifying the fields the comparer looks at, whether the
+  element moved toward the front or the back. The element keeps its
+  original offer order among equal elements.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param handle a handle returned by priqueue_offer_handle()
+  @return 0 if the element was repositioned
+  @return -1 if the handle does not refer to an element in the queue, or
+  q is not a PRIQUEUE_HEAP queue
+ */
+int priqueue_update_key(priqueue_t *q, int handle)
+{
+	if (q->kind != PRIQUEUE_HEAP || handle < 0 || handle >= q->capacity || q->slot_of[handle] < 0)
+		return -1;
+	heap_resift(q, q->slot_of[handle]);
+	return 0;
+}
+
+
+/**
+  Moves every element of src into dst, leaving src empty but initialized.
+
+  Two PRIQUEUE_PAIRING queues are melded in O(1). Equal elements from the
+  two queues then keep the order of their offer sequence numbers, so they
+  may interleave. Any other pair of queues is merged by draining src in
+  priority order into one priqueue_offer_batch() on dst, which places src's
+  elements behind equal elements of dst.
+
+  @param dst the queue receiving the elements
+  @param src the queue giving them up; it must use the same comparer
+  @return the number of elements moved
+ */
+int priqueue_merge(priqueue_t *dst, priqueue_t *src)
+{
+	int n = src->size;
+	if (n == 0 || dst == src)
+		return 0;
+
+	if (dst->kind == PRIQUEUE_PAIRING && src->kind == PRIQUEUE_PAIRING) {
+		pairing_merge(dst, src);
+		return n;
+	}
+
+	void ** drained = malloc(sizeof(void *) * n);
+	for (int i = 0; i < n; i++)
+		drained[i] = priqueue_poll(src);
+	priqueue_offer_batch(dst, drained, n);
+	free(drained);
+	return n;
+}
+
+
+/**
+  Returns the number of elements in the queue.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @return the number of elements in the queue
+ */
+int priqueue_size(priqueue_t *q)
+{
+	return q->size;
+}
+
+
+/**
+  Pre-sizes the queue's storage for a known peak depth so that offers up
+  to that depth do not allocate. PRIQUEUE_BUCKET queues size their levels
+  on demand and ignore this.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param depth the number of elements the queue should hold without growing
+ */
+void priqueue_reserve(priqueue_t *q, int depth)
+{
+	switch (q->kind) {
+		case PRIQUEUE_HEAP:
+			while (q->capacity < depth)
+				heap_grow(q);
+			break;
+		case PRIQUEUE_FIFO:
+			while (q->ring.capacity < depth)
+				fifo_grow(&q->ring);
+			break;
+		case PRIQUEUE_KEYED:
+			while (q->capacity < depth)
+				keyed_grow(q);
+			break;
+		case PRIQUEUE_PAIRING:
+			while (q->pooled < depth) {
+				pairing_node * n = malloc(sizeof(pairing_node));
+				pairing_release(q, n);
+				q->pooled += 1;
+			}
+			break;
+		case PRIQUEUE_BUCKET:
+			break;
+		default:
+			if (q->pooled < depth)
+				node_pool_grow(q, depth - q->pooled);
+			break;
+	}
+}
+
+
+/**
+  Opens a cursor at the head of the queue. The queue must not be changed
+  until the cursor has been closed with priqueue_iter_destroy().
+
+  @param it the cursor to initialize
+  @param q a pointer to an instance of the priqueue_t data structure
+ */
+void priqueue_iter_init(priqueue_iter_t *it, priqueue_t *q)
+{
+	it->q = q;
+	it->next = q->front;
+	it->index = 0;
+	it->level = 0;
+	it->scratch = NULL;
+	it->remaining = q->size;
+
+	// the heaps are only partially ordered, so walk a copy that can be popped
+	if (q->kind == PRIQUEUE_HEAP && q->size > 0) {
+		it->scratch = malloc(sizeof(heap_entry) * q->size);
+		memcpy(it->scratch, q->heap, sizeof(heap_entry) * q->size);
+	} else if (q->kind == PRIQUEUE_KEYED && q->size > 0) {
+		it->scratch = malloc(sizeof(keyed_entry) * q->size);
+		memcpy(it->scratch, q->keyed, sizeof(keyed_entry) * q->size);
+	} else if (q->kind == PRIQUEUE_PAIRING && q->size > 0) {
+		it->scratch = pairing_sorted(q);
+	}
+}
+
+
+/**
+  Advances the cursor.
+
+  @param it a cursor opened with priqueue_iter_init()
+  @return the next element in priority order
+  @return NULL once every element has been returned
+ */
+void *priqueue_iter_next(priqueue_iter_t *it)
+{
+	priqueue_t *q = it->q;
+	void * retv;
+
+	if (it->remaining == 0)
+		return NULL;
+	it->remaining -= 1;
+
+	switch (q->kind) {
+		case PRIQUEUE_HEAP: {
+			heap_entry * scratch = it->scratch;
+			retv = scratch[0].data;
+			scratch[0] = scratch[it->remaining];
+			heap_sift_down(q->cmp, scratch, NULL, it->remaining, 0);
+			return retv;
+		}
+		case PRIQUEUE_KEYED: {
+			keyed_entry * scratch = it->scratch;
+			retv = scratch[0].data;
+			scratch[0] = scratch[it->remaining];
+			keyed_sift_down(scratch, it->remaining, 0);
+			return retv;
+		}
+		case PRIQUEUE_PAIRING:
+			return ((pairing_node **)it->scratch)[it->index++]->data;
+		case PRIQUEUE_FIFO:
+			return FIFO_SLOT(&q->ring, it->index++);
+		case PRIQUEUE_BUCKET:
+			while (it->index >= q->buckets[it->level].size) {
+				it->level += 1;
+				it->index = 0;
+			}
+			return FIFO_SLOT(&q->buckets[it->level], it->index++);
+		default:
+			retv = it->next->data;
+			it->next = it->next->next;
+			return retv;
+	}
+}
+
+
+/**
+  Closes a cursor and frees anything it holds. The queue itself is untouched.
+
+  @param it a cursor opened with priqueue_iter_init()
+ */
+void priqueue_iter_destroy(priqueue_iter_t *it)
+{
+	free(it->scratch);
+	it->scratch = NULL;
+	it->remaining = 0;
+}
+
+
+/**
+  Copies the first max elements of the queue, in priority order, into out
+  in a single pass. The queue is left unchanged.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+  @param out receives up to max element pointers
+  @param max the capacity of out
+  @return the number of elements copied
+ */
+int priqueue_snapshot(priqueue_t *q, void **out, int max)
+{
+	priqueue_iter_t it;
+	int count = (q->size < max) ? q->size : max;
+
+	priqueue_iter_init(&it, q);
+	for (int i = 0; i < count; i++)
+		out[i] = priqueue_iter_next(&it);
+	priqueue_iter_destroy(&it);
+	return (count < 0) ? 0 : count;
+}
+
+
+/**
+  Destroys and frees all the memory associated with q.
+
+  @param q a pointer to an instance of the priqueue_t data structure
+ */
+void priqueue_destroy(priqueue_t *q)
+{
+	switch (q->kind) {
+		case PRIQUEUE_HEAP:
+			heap_destroy(q);
+			break;
+		case PRIQUEUE_FIFO:
+			ring_destroy(q);
+			break;
+		case PRIQUEUE_BUCKET:
+			bucket_destroy(q);
+			break;
+		case PRIQUEUE_KEYED:
+			keyed_destroy(q);
+			break;
+		case PRIQUEUE_PAIRING:
+			pairing_destroy(q);
+			break;
+		default:
+			list_destroy(q);
+			break;
+	}
+}
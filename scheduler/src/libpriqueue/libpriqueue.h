@@ -1,37 +1,162 @@
-/** @file libpriqueue.h
- */
-
-#ifndef LIBPRIQUEUE_H_
-#define LIBPRIQUEUE_H_
-
-/**
-  Priqueue Data Structure
-*/
-typedef int (*comparer)(const void *a, const void *b);
-
-typedef struct node {
-  void * data;
-  struct node * next;
-} node;
-
-typedef struct _priqueue_t
-{
-  node * front;
-  comparer cmp;
-  int size;
-} priqueue_t;
-
-
-void   priqueue_init     (priqueue_t *q, int (*comp)(const void *, const void *));
-
-int    priqueue_offer    (priqueue_t *q, void *ptr);
-void * priqueue_peek     (priqueue_t *q);
-void * priqueue_poll     (priqueue_t *q);
-void * priqueue_at       (priqueue_t *q, int index);
-int    priqueue_remove   (priqueue_t *q, void *ptr);
-void * priqueue_remove_at(priqueue_t *q, int index);
-int    priqueue_size     (priqueue_t *q);
-
-void   priqueue_destroy  (priqueue_t *q);
-
-#endif /* LIBPQUEUE_H_ */
+/** @file libpriqueue.h
+ */
+
+#ifndef LIBPRIQUEUE_H_
+#define LIBPRIQUEUE_H_
+
+#include <stdint.h>
+
+/**
+  Priqueue Data Structure
+*/
+typedef int (*comparer)(const void *a, const void *b);
+
+/**
+  Storage backends a priqueue_t can be initialized with.
+  PRIQUEUE_LIST is the original sorted linked list, PRIQUEUE_HEAP an
+  array-backed d-ary heap with O(log n) offer and poll. PRIQUEUE_FIFO is a
+  ring buffer that ignores the comparer and keeps insertion order, for
+  callers whose keys only ever arrive in order. PRIQUEUE_BUCKET keeps one
+  FIFO per integer priority level, see priqueue_init_buckets().
+  PRIQUEUE_KEYED is a d-ary heap ordered by an integer key stored next to
+  each element, see priqueue_init_keyed(). PRIQUEUE_PAIRING is a pairing
+  heap, which priqueue_merge() can meld into another in O(1).
+*/
+typedef enum {PRIQUEUE_LIST = 0, PRIQUEUE_HEAP, PRIQUEUE_FIFO, PRIQUEUE_BUCKET, PRIQUEUE_KEYED, PRIQUEUE_PAIRING} priqueue_kind_t;
+
+/**
+  Maps an element to its integer key for PRIQUEUE_BUCKET and
+  PRIQUEUE_KEYED; lower keys are served first. Bucket levels run from 0
+  to PRIQUEUE_BUCKET_MAX_LEVELS - 1; keys outside that range are clamped
+  to the nearest level, so callers needing exact order for such keys
+  should use PRIQUEUE_KEYED.
+*/
+typedef int (*priqueue_key)(const void *a);
+
+/** Most levels a PRIQUEUE_BUCKET queue grows to */
+#define PRIQUEUE_BUCKET_MAX_LEVELS (1 << 16)
+
+/** Number of children per heap node */
+#define PRIQUEUE_HEAP_ARITY 4
+
+typedef struct node {
+  void * data;
+  struct node * next;
+} node;
+
+/**
+  A block of list nodes handed out by the per-queue node pool.
+*/
+typedef struct node_chunk {
+  struct node_chunk * next;
+  int count;
+  node nodes[];
+} node_chunk;
+
+typedef struct heap_entry {
+  void * data;
+  unsigned long seq;
+  int handle;
+} heap_entry;
+
+/**
+  Heap entry for PRIQUEUE_KEYED. The upper 32 bits of key hold the
+  element's key and the lower 32 bits its offer sequence number, so one
+  integer compare orders elements and breaks ties by arrival. The live
+  entries are renumbered before the sequence number outgrows 32 bits.
+*/
+typedef struct keyed_entry {
+  uint64_t key;
+  void * data;
+} keyed_entry;
+
+/**
+  Node of a PRIQUEUE_PAIRING heap. Children hang off child as a list
+  linked through sibling; prev points to the left sibling, or to the
+  parent for a first child. Nodes are allocated one by one so they can
+  move to another queue in a merge.
+*/
+typedef struct pairing_node {
+  void * data;
+  unsigned long seq;
+  struct pairing_node * child;
+  struct pairing_node * sibling;
+  struct pairing_node * prev;
+} pairing_node;
+
+typedef struct fifo {
+  void ** slots;
+  int head;
+  int size;
+  int capacity;
+} fifo;
+
+typedef struct _priqueue_t
+{
+  node * front;
+  node * free_nodes;
+  node_chunk * chunks;
+  int pooled;
+  comparer cmp;
+  int size;
+  priqueue_kind_t kind;
+  heap_entry * heap;
+  int * slot_of;
+  int * free_handles;
+  keyed_entry * keyed;
+  int capacity;
+  fifo ring;
+  priqueue_key key;
+  fifo * buckets;
+  unsigned long * occupied;
+  int levels;
+  pairing_node * root;
+  pairing_node * spare;
+  unsigned long seq;
+} priqueue_t;
+
+/**
+  A cursor over a priqueue_t in priority order, see priqueue_iter_init().
+  The heap backends hand out elements from a private copy of the heap, so
+  each step costs O(log n) rather than a fresh walk from the head.
+*/
+typedef struct _priqueue_iter_t
+{
+  priqueue_t * q;
+  node * next;
+  int index;
+  int level;
+  void * scratch;
+  int remaining;
+} priqueue_iter_t;
+
+
+void   priqueue_init     (priqueue_t *q, int (*comp)(const void *, const void *));
+void   priqueue_init_kind(priqueue_t *q, int (*comp)(const void *, const void *), priqueue_kind_t kind);
+void   priqueue_init_buckets(priqueue_t *q, int (*comp)(const void *, const void *), priqueue_key key, int levels);
+void   priqueue_init_keyed  (priqueue_t *q, int (*comp)(const void *, const void *), priqueue_key key);
+void   priqueue_init_from_array(priqueue_t *q, int (*comp)(const void *, const void *), priqueue_kind_t kind, void **ptrs, int n);
+
+int    priqueue_offer    (priqueue_t *q, void *ptr);
+int    priqueue_offer_batch(priqueue_t *q, void **ptrs, int n);
+void * priqueue_peek     (priqueue_t *q);
+void * priqueue_poll     (priqueue_t *q);
+void * priqueue_at       (priqueue_t *q, int index);
+int    priqueue_remove   (priqueue_t *q, void *ptr);
+void * priqueue_remove_at(priqueue_t *q, int index);
+int    priqueue_offer_handle (priqueue_t *q, void *ptr);
+void * priqueue_remove_handle(priqueue_t *q, int handle);
+int    priqueue_update_key   (priqueue_t *q, int handle);
+int    priqueue_offer_keyed  (priqueue_t *q, void *ptr, int key);
+int    priqueue_merge    (priqueue_t *dst, priqueue_t *src);
+int    priqueue_size     (priqueue_t *q);
+void   priqueue_reserve  (priqueue_t *q, int depth);
+
+void   priqueue_iter_init   (priqueue_iter_t *it, priqueue_t *q);
+void * priqueue_iter_next   (priqueue_iter_t *it);
+void   priqueue_iter_destroy(priqueue_iter_t *it);
+int    priqueue_snapshot    (priqueue_t *q, void **out, int max);
+
+void   priqueue_destroy  (priqueue_t *q);
+
+#endif /* LIBPQUEUE_H_ */
@@ -0,0 +1,199 @@
+/** @file libpriqueue_typed.h
+ */
+
+#ifndef LIBPRIQUEUE_TYPED_H_
+#define LIBPRIQUEUE_TYPED_H_
+
+#include <stdlib.h>
+
+/** Number of children per node in generated heaps */
+#define PRIQUEUE_TYPED_ARITY 4
+
+/**
+  Generates a type-specialized priority queue.
+
+  PRIQUEUE_DEFINE(name, elem_type, less_expr) emits a struct type @c name
+  and static inline functions name_init, name_reserve, name_offer,
+  name_peek, name_poll, name_size, name_clear and name_destroy. Elements are stored by
+  value in a d-ary heap and the ordering is the expression @c less_expr,
+  written in terms of two elem_type values @c a and @c b, which is true when
+  @c a should leave the queue before @c b. The compiler sees the
+  comparison directly, so it can inline it instead of calling through a
+  function pointer. Elements that are neither before nor after each other
+  leave in the order they were offered.
+
+  For example, a queue of jobs ordered by run time:
+
+    PRIQUEUE_DEFINE(sjf_queue, job_t *, a->running_time < b->running_time)
+
+  name_peek and name_poll may only be called on a non-empty queue.
+*/
+#define PRIQUEUE_DEFINE(name, elem_type, less_expr) \
+	PRIQUEUE_DEFINE_IMPL(name, elem_type, less_expr, (void)0)
+
+/**
+  Like PRIQUEUE_DEFINE, for elements that can be repositioned or removed
+  while queued. @c index_lvalue, written in terms of an element @c a, is an
+  int the queue keeps set to the element's position in the heap, such as a
+  field of the pointed-to struct. Two more functions take that position:
+  name_update restores the order after the element's key changed, and
+  name_remove takes the element out of the queue. A removed element's
+  index is left as it was.
+
+    PRIQUEUE_DEFINE_INDEXED(timers, timer_t *, a->deadline < b->deadline, a->slot)
+*/
+#define PRIQUEUE_DEFINE_INDEXED(name, elem_type, less_expr, index_lvalue) \
+	PRIQUEUE_DEFINE_IMPL(name, elem_type, less_expr, index_lvalue = i)
+
+#define PRIQUEUE_DEFINE_IMPL(name, elem_type, less_expr, place_stmt)           \
+                                                                               \
+typedef struct name##_entry {                                                  \
+	elem_type elem;                                                            \
+	unsigned long seq;                                                         \
+} name##_entry;                                                                \
+                                                                               \
+typedef struct name {                                                          \
+	name##_entry * heap;                                                       \
+	int size;                                                                  \
+	int capacity;                                                              \
+	unsigned long seq;                                                         \
+} name;                                                                        \
+                                                                               \
+static inline int name##_before(const name##_entry *x, const name##_entry *y)  \
+{                                                                              \
+	{                                                                          \
+		elem_type a = x->elem;                                                 \
+		elem_type b = y->elem;                                                 \
+		if (less_expr)                                                         \
+			return 1;                                                          \
+	}                                                                          \
+	{                                                                          \
+		elem_type a = y->elem;                                                 \
+		elem_type b = x->elem;                                                 \
+		if (less_expr)                                                         \
+			return 0;                                                          \
+	}                                                                          \
+	return x->seq < y->seq;                                                    \
+}                                                                              \
+                                                                               \
+static inline void name##_place(name *q, int i, name##_entry e)                \
+{                                                                              \
+	q->heap[i] = e;                                                            \
+	{                                                                          \
+		elem_type a = e.elem;                                                  \
+		(void)a;                                                               \
+		place_stmt;                                                            \
+	}                                                                          \
+}                                                                              \
+                                                                               \
+static inline int name##_sift_up(name *q, int i, name##_entry e)               \
+{                                                                              \
+	while (i > 0) {                                                            \
+		int parent = (i - 1) / PRIQUEUE_TYPED_ARITY;                           \
+		if (!name##_before(&e, &q->heap[parent]))                              \
+			break;                                                             \
+		name##_place(q, i, q->heap[parent]);                                   \
+		i = parent;                                                            \
+	}                                                                          \
+	name##_place(q, i, e);                                                     \
+	return i;                                                                  \
+}                                                                              \
+                                                                               \
+static inline void name##_sift_down(name *q, int i, name##_entry e)            \
+{                                                                              \
+	int n = q->size;                                                           \
+	while (1) {                                                                \
+		int first = i * PRIQUEUE_TYPED_ARITY + 1;                              \
+		if (first >= n)                                                        \
+			break;                                                             \
+		int last = first + PRIQUEUE_TYPED_ARITY;                               \
+		if (last > n)                                                          \
+			last = n;                                                          \
+		int best = first;                                                      \
+		for (int c = first + 1; c < last; c++) {                               \
+			if (name##_before(&q->heap[c], &q->heap[best]))                    \
+				best = c;                                                      \
+		}                                                                      \
+		if (!name##_before(&q->heap[best], &e))                                \
+			break;                                                             \
+		name##_place(q, i, q->heap[best]);                                     \
+		i = best;                                                              \
+	}                                                                          \
+	name##_place(q, i, e);                                                     \
+}                                                                              \
+                                                                               \
+static inline void name##_init(name *q)                                        \
+{                                                                              \
+	q->heap = NULL;                                                            \
+	q->size = 0;                                                               \
+	q->capacity = 0;                                                           \
+	q->seq = 0;                                                                \
+}                                                                              \
+                                                                               \
+static inline void name##_reserve(name *q, int depth)                          \
+{                                                                              \
+	if (depth > q->capacity) {                                                 \
+		q->capacity = depth;                                                   \
+		q->heap = realloc(q->heap, sizeof(name##_entry) * depth);              \
+	}                                                                          \
+}                                                                              \
+                                                                               \
+static inline int name##_offer(name *q, elem_type elem)                        \
+{                                                                              \
+	if (q->size == q->capacity)                                                \
+		name##_reserve(q, (q->capacity == 0) ? 16 : q->capacity * 2);          \
+	name##_entry e = { elem, q->seq++ };                                       \
+	return name##_sift_up(q, q->size++, e);                                    \
+}                                                                              \
+                                                                               \
+static inline elem_type name##_peek(name *q)                                   \
+{                                                                              \
+	return q->heap[0].elem;                                                    \
+}                                                                              \
+                                                                               \
+static inline elem_type name##_poll(name *q)                                   \
+{                                                                              \
+	elem_type retv = q->heap[0].elem;                                          \
+	name##_entry e = q->heap[--q->size];                                       \
+	if (q->size > 0)                                                           \
+		name##_sift_down(q, 0, e);                                             \
+	return retv;                                                               \
+}                                                                              \
+                                                                               \
+static inline void name##_update(name *q, int i)                               \
+{                                                                              \
+	name##_entry e = q->heap[i];                                               \
+	if (i > 0 && name##_before(&e, &q->heap[(i - 1) / PRIQUEUE_TYPED_ARITY]))  \
+		name##_sift_up(q, i, e);                                               \
+	else                                                                       \
+		name##_sift_down(q, i, e);                                             \
+}                                                                              \
+                                                                               \
+static inline elem_type name##_remove(name *q, int i)                          \
+{                                                                              \
+	elem_type retv = q->heap[i].elem;                                          \
+	name##_entry e = q->heap[--q->size];                                       \
+	if (i < q->size) {                                                         \
+		q->heap[i] = e;                                                        \
+		name##_update(q, i);                                                   \
+	}                                                                          \
+	return retv;                                                               \
+}                                                                              \
+                                                                               \
+static inline int name##_size(name *q)                                         \
+{                                                                              \
+	return q->size;                                                            \
+}                                                                              \
+                                                                               \
+static inline void name##_clear(name *q)                                       \
+{                                                                              \
+	q->size = 0;                                                               \
+}                                                                              \
+                                                                               \
+static inline void name##_destroy(name *q)                                     \
+{                                                                              \
+	free(q->heap);                                                             \
+	name##_init(q);                                                            \
+}
+
+#endif /* LIBPRIQUEUE_TYPED_H_ */
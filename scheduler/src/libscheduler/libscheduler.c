@@ -1,455 +1,1035 @@
-/** @file libscheduler.c
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#include "libscheduler.h"
-#include "../libpriqueue/libpriqueue.h"
-
-
-/**
-  Stores information making up a job to be scheduled including any statistics.
-
-  You may need to define some global variables or a struct to store your job queue elements.
-*/
-int FCFS_cmp(void * job1, void * job2);
-int SJF_cmp(void * job1, void * job2);
-int PSJF_cmp(void * job1, void * job2);
-int PRI_cmp(void * job1, void * job2);
-int RR_cmp(void * job1, void * job2);
-
-comparer determine_cmp(scheme_t scheme);
-
-typedef struct job_t{
-	int job_id;
-	int priority;
-	float arrival_time;
-	float running_time;
-	float start_time;
-	float remaining_time;
-	float last_start_time;
-} job_t;
-
-typedef struct core{
-	int id;
-	bool idle;
-	job_t * running_job;
-} core;
-
-core* cores;
-priqueue_t wait_queue;
-int NUM_CORES = 0;
-bool preemptive;
-int current_time = 0;
-int numJobs = 0;
-float totalTurnTime = 0;
-float totalWaitTime = 0;
-float totalRespTime = 0;
-
-
-/**
-  Initalizes the scheduler.
-
-  Assumptions:
-    - You may assume this will be the first scheduler function called.
-    - You may assume this function will be called once.
-    - You may assume that cores is a positive, non-zero number.
-    - You may assume that scheme is a valid scheduling scheme.
-
-  @param cores the number of cores that is available by the scheduler. These cores will be known as core(id=0), core(id=1), ..., core(id=cores-1).
-  @param scheme  the scheduling scheme that should be used. This value will be one of the six enum values of scheme_t
-*/
-void scheduler_start_up(int num_cores, scheme_t scheme)
-{
-	cores = malloc(sizeof(core) * num_cores);
-	priqueue_init(&wait_queue, determine_cmp(scheme));
-	NUM_CORES = num_cores;
-
-	for(int i = 0; i < num_cores; i++) {
-		cores[i].id = i;
-		cores[i].idle = true;
-		cores[i].running_job = NULL;
-	}
-}
-
-/**
-	Helper function to determine compare function to use
-	@param scheme_t
-	@return comparer
-*/
-comparer determine_cmp(scheme_t scheme)
-{
-	comparer cmp;
-	switch (scheme){
-		case FCFS:
-			cmp = (comparer)&FCFS_cmp;
-			preemptive = false;
-			break;
-		case RR:
-			cmp = (comparer)&RR_cmp;
-			preemptive = true;
-			break;
-		case SJF:
-			cmp = (comparer)&SJF_cmp;
-			preemptive = false;
-			break;
-		case PSJF:
-			cmp = (comparer)&PSJF_cmp;
-			preemptive = true;
-			break;
-		case PRI:
-			cmp = (comparer)&PRI_cmp;
-			preemptive = false;
-			break;
-		case PPRI:
-			cmp = (comparer)&PRI_cmp;
-			preemptive = true;
-			break;
-		}
-		return cmp;
-}
-
-/**
-  Called when a new job arrives.
-
-  If multiple cores are idle, the job should be assigned to the core with the
-  lowest id.
-  If the job arriving should be scheduled to run during the next
-  time cycle, return the zero-based index of the core the job should be
-  scheduled on. If another job is already running on the core specified,
-  this will preempt the currently running job.
-  Assumptions:
-    - You may assume that every job wil have a unique arrival time.
-
-  @param job_number a globally unique identification number of the job arriving.
-  @param time_a the current time of the simulator.
-  @param running_time the total number of time units this job will run before it will be finished.
-  @param priority the priority of the job. (The lower the value, the higher the priority.)
-  @return index of core job should be scheduled on
-  @return -1 if no scheduling changes should be made.
-
- */
-int scheduler_new_job(int job_number, int time_a, int running_time, int priority)
-{
-	job_t * new_job = malloc(sizeof(job_t));
-	new_job->job_id = job_number;
-	new_job->arrival_time = time_a;
-	new_job->running_time = running_time;
-	new_job->remaining_time = running_time;
-	new_job->priority = priority;
-	new_job->start_time = -1;
-	new_job->last_start_time = -1;
-
-	//check cores and store
-	for (int i = 0; i < NUM_CORES; i++) {
-		// If theres an idle queue add it there and return that core id
-		if(cores[i].idle) {
-			new_job->start_time = time_a;
-			new_job->last_start_time = time_a;
-			cores[i].running_job = new_job;
-			cores[i].idle = false;
-			return i;
-		}
-	}
-	// if its a preemptive scheme and need to add it to a queue, add it to the shortest queue and return
-	if (preemptive){
-		//find least preferential job
-
-		// update each cores running time
-		for (int i = 0; i < NUM_CORES; i++){
-			cores[i].running_job->remaining_time = cores[i].running_job->remaining_time - (time_a - cores[i].running_job->last_start_time);
-			cores[i].running_job->last_start_time = time_a;
-		}
-		priqueue_t t_q;
-		int core_to_assign = -1;
-		priqueue_init(&t_q, wait_queue.cmp);
-		for (int i = 0; i < NUM_CORES; i ++){
-			priqueue_offer(&t_q, cores[i].running_job);
-		}
-		job_t * temp_job = (job_t *)priqueue_remove_at(&t_q, NUM_CORES-1);
-		printf("Job from back is : %d\n", temp_job->job_id);
-		priqueue_destroy(&t_q);
-		// end getting job
-		//
-		// printf("Temp job remaining time before change: %f\n", temp_job->remaining_time);
-		// printf("Time a : %d   temp job start time: %f\n", time_a, temp_job->start_time);
-
-		// printf("Temp job remaining time after change: %f\n", temp_job->remaining_time);
-		for (int i  = 0; i < NUM_CORES; i++){
-			if (temp_job == cores[i].running_job){
-				core_to_assign = i;
-				break;
-			}
-		}
-
-		//compare jobs here
-		//printf("REMAING TIMES: %f,%f\n", new_job->remaining_time, temp_job->remaining_time);
-		//temp_job->remaining_time = temp_job->remaining_time - temp_job->running_time;
-		//printf("temp job last start time: %f\n", temp_job->last_start_time);
-
-		// printf("REMAING TIMES: %f,%f\n", new_job->remaining_time, temp_job->remaining_time);
-		if (wait_queue.cmp(new_job, temp_job) == -1) {
-			temp_job->last_start_time = -1;
-			priqueue_offer(&wait_queue, temp_job);
-			if(new_job->start_time == -1) {
-				new_job->start_time = time_a;
-				new_job->last_start_time = time_a;
-			}
-			cores[core_to_assign].running_job = new_job;
-			// printf("REMAING TIMES: %f,%f\n", new_job->remaining_time, temp_job->remaining_time);
-			return core_to_assign;
-		}
-	}
-	// if neither of the other two conditions met, add it to a global queue and return -1
-
-	priqueue_offer(&wait_queue, new_job);
-	return -1;
-}
-
-
-/**
-  Called when a job has completed execution.
-
-  The core_id, job_number and time parameters are provided for convenience. You may be able to calculate the values with your own data structure.
-  If any job should be scheduled to run on the core free'd up by the
-  finished job, return the job_number of the job that should be scheduled to
-  run on core core_id.
-
-  @param core_id the zero-based index of the core where the job was located.
-  @param job_number a globally unique identification number of the job.
-  @param time the current time of the simulator.
-  @return job_number of the job that should be scheduled to run on core core_id
-  @return -1 if core should remain idle.
- */
-int scheduler_job_finished(int core_id, int job_number, int time_e)
-{
-	//job_t * t_job = (job_t *)priqueue_poll(&cores[core_id].q);
-	job_t * t_job = cores[core_id].running_job;
-	numJobs += 1;
-	totalWaitTime += ((time_e - t_job->running_time) - t_job->arrival_time);
-	totalRespTime += t_job->start_time - t_job->arrival_time;
-	totalTurnTime += time_e - t_job->arrival_time;
-
-	// Free the job
-	free(t_job);
-
-	if (priqueue_peek(&wait_queue) == NULL) {
-		cores[core_id].idle = true;
-		return -1;
-	}
-
-	job_t * new_job = (job_t *)priqueue_poll(&wait_queue);
-	// If the job doesn't have a start time, give it one
-	if (new_job->start_time == -1) { //(new_job->start_time == -1){
-		new_job->start_time = time_e;
-	}
-	// job is starting so set its last start time to now
-	new_job->last_start_time = time_e;
-	// set the new running job
-	cores[core_id].running_job = new_job;
-	return new_job->job_id;
-}
-
-
-/**
-  When the scheme is set to RR, called when the quantum timer has expired
-  on a core.
-
-  If any job should be scheduled to run on the core free'd up by
-  the quantum expiration, return the job_number of the job that should be
-  scheduled to run on core core_id.
-
-  @param core_id the zero-based index of the core where the quantum has expired.
-  @param time the current time of the simulator.
-  @return job_number of the job that should be scheduled on core cord_id
-  @return -1 if core should remain idle
- */
-int scheduler_quantum_expired(int core_id, int time_c)
-{
-	// get the preempted job
-	job_t * job = cores[core_id].running_job;
-	// set the jobs remaining time
-	job->remaining_time -= (time_c - job->last_start_time);
-	// get job id
-	priqueue_offer(&wait_queue, job);
-	// Check to see if the next job exists
-	if (priqueue_peek(&wait_queue) == NULL) {
-		cores[core_id].idle = true;
-		return -1;
-	}
-
-	job_t * new_job = (job_t *)priqueue_poll(&wait_queue);
-
-	// If the job doesn't have a start time, give it one
-	if (new_job->start_time == -1){
-		new_job->start_time = time_c;
-		new_job->last_start_time = time_c;
-	}
-	cores[core_id].running_job = new_job;
-	return new_job->job_id;
-}
-
-
-/**
-  Returns the average waiting time of all jobs scheduled by your scheduler.
-
-  Assumptions:
-    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
-  @return the average waiting time of all jobs scheduled.
- */
-float scheduler_average_waiting_time()
-{
-	float retv = (float)totalWaitTime / (float)numJobs;
-	return retv;
-}
-
-
-/**
-  Returns the average turnaround time of all jobs scheduled by your scheduler.
-
-  Assumptions:
-    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
-  @return the average turnaround time of all jobs scheduled.
- */
-float scheduler_average_turnaround_time()
-{
-	float retv = (float)totalTurnTime / (float)numJobs;
-	return retv;
-}
-
-
-/**
-  Returns the average response time of all jobs scheduled by your scheduler.
-
-  Assumptions:
-    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
-  @return the average response time of all jobs scheduled.
- */
-float scheduler_average_response_time()
-{
-	float retv = (float)totalRespTime / (float)numJobs;
-	return retv;
-}
-
-
-/**
-  Free any memory associated with your scheduler.
-
-  Assumptions:
-    - This function will be the last function called in your library.
-*/
-void scheduler_clean_up()
-{
-	for (int i = 0; i < NUM_CORES; i ++){
-		cores[i].running_job = NULL;
-	}
-	priqueue_destroy(&wait_queue);
-	free(cores);
-}
-
-
-/**
-  This function may print out any debugging information you choose. This
-  function will be called by the simulator after every call the simulator
-  makes to your scheduler.
-  In our provided output, we have implemented this function to list the jobs in the order they are to be scheduled.
-	Furthermore, we have also listed the current state of the job (either running on a given core or idle).
-	For example, if we have a non-preemptive algorithm and job(id=4) has began running,
-	job(id=2) arrives with a higher priority, and job(id=1) arrives with a lower priority, the output in our sample output will be:
-
-    2(-1) 4(0) 1(-1)
-
-  This function is not required and will not be graded. You may leave it
-  blank if you do not find it useful.
- */
-void scheduler_show_queue()
-{
-	printf("RUNNING JOBS:\n");
-	job_t * print_job;
-	for (int i = 0; i < NUM_CORES; i++){
-		print_job = cores[i].running_job;
-		if (cores[i].idle){
-			printf("CORE IS IDLE");
-		}
-		else{
-			printf("Core #%d: job_id: %d  job_priority: %d   remaining_time: %f\n", i, print_job->job_id, print_job->priority, print_job->remaining_time);
-		}
-	}
-
-	printf("\nJOBS IN QUEUE:\n");
-	if (priqueue_size(&wait_queue) <= 0){
-		printf("NO JOBS IN QUEUE\n");
-	}
-	for (int i = 0; i < priqueue_size(&wait_queue); i++){
-		print_job = (job_t *)(priqueue_at(&wait_queue, i));
-		printf("job_id: %d   job_priority: %d    remaining_time: %f\n", print_job->job_id, print_job->priority, print_job->remaining_time);
-	}
-}
-
-
-int FCFS_cmp(void * a, void * b){
-	int retv;
-	job_t * job_a = (job_t *)a;
-	job_t * job_b = (job_t *)b;
-
-	if (job_a->arrival_time < job_b->arrival_time){
-		retv = -1;
-	}else if(job_a->arrival_time == job_b->arrival_time){
-		retv = 0;
-	}else{
-		retv = 1;
-	}
-	return retv;
-}
-
-int SJF_cmp(void * a, void * b){
-	int retv;
-	job_t * job_a = (job_t *)a;
-	job_t * job_b = (job_t *)b;
-	if (job_a->running_time < job_b->running_time){
-		retv = -1;
-	}else if(job_a->running_time == job_b->running_time){
-		retv = 0;
-	}else{
-		retv = 1;
-	}
-	return retv;
-}
-
-int PSJF_cmp(void * a, void * b){
-	int retv;
-	job_t * job_a = (job_t *)a;
-	job_t * job_b = (job_t *)b;
-	if (job_a->remaining_time < job_b->remaining_time){
-		retv = -1;
-	}else if(job_a->remaining_time == job_b->remaining_time){
-		retv = 0;
-	}else{
-		retv = 1;
-	}
-	return retv;
-}
-
-int PRI_cmp(void * a, void * b){
-	int retv;
-	job_t * job_a = (job_t *)a;
-	job_t * job_b = (job_t *)b;
-	if (job_a->priority < job_b->priority){
-		retv = -1;
-	}else if(job_a->priority == job_b->priority){
-		retv =  0;
-	}else{
-		retv =  1;
-	}
-	return retv;
-}
-
-int RR_cmp(void * a, void * b){
-	return 1;
-}
-
-void increment_timer(int time_c) {
-	time_c++;
-}
+/** @file libscheduler.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libscheduler.h"
+#include "../libpriqueue/libpriqueue.h"
+#include "../libpriqueue/libpriqueue_typed.h"
+
+
+/**
+  Stores information making up a job to be scheduled including any statistics.
+
+  You may need to define some global variables or a struct to store your job queue elements.
+*/
+int FCFS_cmp(const void * job1, const void * job2);
+int SJF_cmp(const void * job1, const void * job2);
+int PSJF_cmp(const void * job1, const void * job2);
+int PRI_cmp(const void * job1, const void * job2);
+int RR_cmp(const void * job1, const void * job2);
+int SJF_key(const void * job);
+int PSJF_key(const void * job);
+int PRI_key(const void * job);
+
+/** Priority levels the bucket queue starts with; it grows if a trace uses more */
+#define PRI_LEVELS 16
+
+comparer determine_cmp(scheduler_t * s, scheme_t scheme);
+
+typedef struct job_t{
+	int job_id;
+	int priority;
+	float arrival_time;
+	float running_time;
+	float start_time;
+	float remaining_time;
+	struct job_t * next_free;
+} job_t;
+
+/**
+  A block of job records. Jobs are carved out of chunks so their addresses
+  stay stable while they sit in queues, and finished jobs are recycled
+  through a free list, so the arena only grows to the peak number of live
+  jobs.
+*/
+typedef struct job_chunk{
+	struct job_chunk * next;
+	int count;
+	job_t jobs[];
+} job_chunk;
+
+#define JOB_CHUNK_MIN 64
+
+/**
+  A core and the job on it. The running job's remaining_time is as of
+  dispatch_time, when it was put on the core; it is brought up to date only
+  when the job leaves the core, see job_remaining(). In QUEUE_PER_CORE mode
+  the core also owns the run queue of jobs waiting for it.
+*/
+typedef struct core{
+	int id;
+	bool idle;
+	job_t * running_job;
+	float dispatch_time;
+	int victim_handle;
+	priqueue_t run_queue;
+	int peak_queue;
+	int steals;
+} core;
+
+/**
+	Victim heap orderings: true when a new arrival should preempt core a
+	before core b, ties going to the highest core. Running jobs all lose
+	remaining time at the same rate, so a PSJF job's place is fixed by when
+	it would finish: dispatch_time + remaining_time.
+*/
+static inline bool PSJF_victim_before(const core * a, const core * b){
+	float finish_a = a->dispatch_time + a->running_job->remaining_time;
+	float finish_b = b->dispatch_time + b->running_job->remaining_time;
+
+	if (finish_a != finish_b)
+		return finish_a > finish_b;
+	return a->id > b->id;
+}
+
+static inline bool PRI_victim_before(const core * a, const core * b){
+	if (a->running_job->priority != b->running_job->priority)
+		return a->running_job->priority > b->running_job->priority;
+	return a->id > b->id;
+}
+
+/**
+	Busy cores ordered by the victim orderings, one specialization per
+	preemptive scheme, so the comparison is compiled into the heap. Each
+	core keeps its position in victim_handle.
+*/
+PRIQUEUE_DEFINE_INDEXED(psjf_victims, core *, PSJF_victim_before(a, b), a->victim_handle)
+PRIQUEUE_DEFINE_INDEXED(pri_victims, core *, PRI_victim_before(a, b), a->victim_handle)
+
+/**
+  Everything one scheduler instance owns. Each simulation gets its own, so
+  several can run side by side in one process.
+*/
+struct scheduler_t{
+	core* cores;
+	priqueue_t wait_queue;
+	queue_mode_t queue_mode;
+	int NUM_CORES;
+	bool preemptive;
+	priqueue_kind_t queue_kind;
+	priqueue_key queue_key;
+	scheme_t active_scheme;
+	psjf_victims psjf_running;
+	pri_victims pri_running;
+	int now;
+	int numJobs;
+	float totalTurnTime;
+	float totalWaitTime;
+	float totalRespTime;
+	job_chunk * job_chunks;
+	job_t * free_jobs;
+	int pooled_jobs;
+	void ** pending;
+	int pending_capacity;
+};
+
+/** The instance behind the scheduler_* calls that take no scheduler_t */
+scheduler_t * default_scheduler = NULL;
+
+job_t * job_alloc(scheduler_t * s);
+job_t * job_create(scheduler_t * s, int job_number, int time, int running_time, int priority);
+int job_place(scheduler_t * s, job_t * job, int time, job_t ** waiting, core ** owner);
+void job_enqueue(scheduler_t * s, core * owner, job_t * job);
+job_t * next_job(scheduler_t * s, int core_id);
+void queue_init(scheduler_t * s, priqueue_t * q, comparer cmp);
+void queue_rekey(scheduler_t * s);
+core * least_loaded_core(scheduler_t * s);
+core * most_loaded_core(scheduler_t * s, int core_id);
+void job_release(scheduler_t * s, job_t * job);
+core * least_preferred_core(scheduler_t * s);
+void victim_update(scheduler_t * s, int core_id);
+float job_remaining(const core * c, float time);
+void core_dispatch(scheduler_t * s, int core_id, job_t * job, int time);
+void core_release(scheduler_t * s, int core_id, int time);
+
+
+/**
+  Creates and initalizes a scheduler instance.
+
+  Assumptions:
+    - You may assume this will be the first function called on the instance.
+    - You may assume that cores is a positive, non-zero number.
+    - You may assume that scheme is a valid scheduling scheme.
+
+  @param cores the number of cores that is available by the scheduler. These cores will be known as core(id=0), core(id=1), ..., core(id=cores-1).
+  @param scheme  the scheduling scheme that should be used. This value will be one of the six enum values of scheme_t
+  @return the new scheduler, released by scheduler_clean_up_r()
+*/
+scheduler_t * scheduler_start_up_r(int num_cores, scheme_t scheme)
+{
+	return scheduler_start_up_mode_r(num_cores, scheme, QUEUE_SHARED);
+}
+
+/**
+  Creates a scheduler instance like scheduler_start_up_r(), choosing
+  whether waiting jobs share one queue or each core keeps its own.
+
+  @param cores the number of cores that is available by the scheduler.
+  @param scheme the scheduling scheme that should be used.
+  @param mode QUEUE_SHARED or QUEUE_PER_CORE
+  @return the new scheduler, released by scheduler_clean_up_r()
+*/
+scheduler_t * scheduler_start_up_mode_r(int num_cores, scheme_t scheme, queue_mode_t mode)
+{
+	scheduler_t * s = calloc(1, sizeof(scheduler_t));
+	s->cores = malloc(sizeof(core) * num_cores);
+	comparer cmp = determine_cmp(s, scheme);
+	queue_init(s, &s->wait_queue, cmp);
+	s->queue_mode = mode;
+	s->NUM_CORES = num_cores;
+	s->active_scheme = scheme;
+	// busy cores ordered worst running job first, for PSJF and PPRI preemption
+	psjf_victims_init(&s->psjf_running);
+	pri_victims_init(&s->pri_running);
+	if (scheme == PSJF)
+		psjf_victims_reserve(&s->psjf_running, num_cores);
+	else if (scheme == PPRI)
+		pri_victims_reserve(&s->pri_running, num_cores);
+
+	for(int i = 0; i < num_cores; i++) {
+		s->cores[i].id = i;
+		s->cores[i].idle = true;
+		s->cores[i].running_job = NULL;
+		s->cores[i].victim_handle = -1;
+		s->cores[i].peak_queue = 0;
+		s->cores[i].steals = 0;
+		if (mode == QUEUE_PER_CORE)
+			queue_init(s, &s->cores[i].run_queue, cmp);
+	}
+	return s;
+}
+
+/**
+	Helper function to determine compare function to use. Also selects
+	whether the scheme is preemptive, which queue backend it runs on and,
+	for the integer-keyed backends, the key function.
+	@param s the scheduler being set up
+	@param scheme_t
+	@return comparer
+*/
+comparer determine_cmp(scheduler_t * s, scheme_t scheme)
+{
+	comparer cmp;
+	s->queue_kind = PRIQUEUE_LIST;
+	s->queue_key = NULL;
+	switch (scheme){
+		case FCFS:
+			cmp = &FCFS_cmp;
+			// arrival times only increase, so insertion order is already sorted
+			s->queue_kind = PRIQUEUE_FIFO;
+			s->preemptive = false;
+			break;
+		case RR:
+			cmp = &RR_cmp;
+			s->queue_kind = PRIQUEUE_FIFO;
+			s->preemptive = true;
+			break;
+		case SJF:
+			cmp = &SJF_cmp;
+			s->queue_kind = PRIQUEUE_KEYED;
+			s->queue_key = &SJF_key;
+			s->preemptive = false;
+			break;
+		case PSJF:
+			cmp = &PSJF_cmp;
+			s->queue_kind = PRIQUEUE_KEYED;
+			s->queue_key = &PSJF_key;
+			s->preemptive = true;
+			break;
+		case PRI:
+			cmp = &PRI_cmp;
+			s->queue_kind = PRIQUEUE_BUCKET;
+			s->queue_key = &PRI_key;
+			s->preemptive = false;
+			break;
+		case PPRI:
+			cmp = &PRI_cmp;
+			s->queue_kind = PRIQUEUE_BUCKET;
+			s->queue_key = &PRI_key;
+			s->preemptive = true;
+			break;
+		}
+		return cmp;
+}
+
+/**
+  Called when a new job arrives.
+
+  If multiple cores are idle, the job should be assigned to the core with the
+  lowest id.
+  If the job arriving should be scheduled to run during the next
+  time cycle, return the zero-based index of the core the job should be
+  scheduled on. If another job is already running on the core specified,
+  this will preempt the currently running job.
+  Assumptions:
+    - You may assume that every job wil have a unique arrival time.
+
+  @param s the scheduler instance
+  @param job_number a globally unique identification number of the job arriving.
+  @param time_a the current time of the simulator.
+  @param running_time the total number of time units this job will run before it will be finished.
+  @param priority the priority of the job. (The lower the value, the higher the priority.)
+  @return index of core job should be scheduled on
+  @return -1 if no scheduling changes should be made.
+
+ */
+int scheduler_new_job_r(scheduler_t * s, int job_number, int time_a, int running_time, int priority)
+{
+	job_t * new_job = job_create(s, job_number, time_a, running_time, priority);
+	job_t * waiting;
+	core * owner;
+	s->now = time_a;
+
+	int core_id = job_place(s, new_job, time_a, &waiting, &owner);
+	if (waiting != NULL)
+		job_enqueue(s, owner, waiting);
+	return core_id;
+}
+
+
+/**
+  Called when several jobs arrive in the same time unit, as a burst.
+
+  The outcome is the same as calling scheduler_new_job_r() for each job in
+  array order, but every job that ends up waiting is added to the queue in
+  a single priqueue_offer_batch() rather than one offer at a time. In
+  QUEUE_PER_CORE mode each arrival picks the shortest run queue as it
+  stands, so those jobs are queued one by one.
+
+  @param s the scheduler instance
+  @param count the number of jobs arriving
+  @param job_numbers the identification number of each job
+  @param time_a the current time of the simulator.
+  @param running_times the running time of each job
+  @param priorities the priority of each job
+  @param core_ids filled in with the core each job is running on once the
+  whole burst has been placed, or -1 for a job left waiting; a job placed
+  early in the burst may be preempted by a later one
+  @return the number of jobs that are running on a core
+ */
+int scheduler_new_jobs_r(scheduler_t * s, int count, const int * job_numbers, int time_a, const int * running_times, const int * priorities, int * core_ids)
+{
+	int waiting_count = 0, running = 0;
+	s->now = time_a;
+
+	// each arrival queues at most one job, itself or the job it preempts
+	if (s->pending_capacity < count) {
+		s->pending_capacity = count;
+		s->pending = realloc(s->pending, sizeof(void *) * count);
+	}
+
+	// placing a job only looks at the cores, so the queue can be filled last
+	for (int i = 0; i < count; i++) {
+		job_t * new_job = job_create(s, job_numbers[i], time_a, running_times[i], priorities[i]);
+		job_t * waiting;
+		core * owner;
+		core_ids[i] = job_place(s, new_job, time_a, &waiting, &owner);
+		if (owner != NULL)
+			job_enqueue(s, owner, waiting);
+		else if (waiting != NULL)
+			s->pending[waiting_count++] = waiting;
+	}
+	priqueue_offer_batch(&s->wait_queue, s->pending, waiting_count);
+
+	for (int i = 0; i < count; i++) {
+		if (core_ids[i] != -1 && s->cores[core_ids[i]].running_job->job_id != job_numbers[i])
+			core_ids[i] = -1;
+		running += (core_ids[i] != -1);
+	}
+	return running;
+}
+
+
+/**
+  Called when a job has completed execution.
+
+  The core_id, job_number and time parameters are provided for convenience. You may be able to calculate the values with your own data structure.
+  If any job should be scheduled to run on the core free'd up by the
+  finished job, return the job_number of the job that should be scheduled to
+  run on core core_id.
+
+  @param s the scheduler instance
+  @param core_id the zero-based index of the core where the job was located.
+  @param job_number a globally unique identification number of the job.
+  @param time the current time of the simulator.
+  @return job_number of the job that should be scheduled to run on core core_id
+  @return -1 if core should remain idle.
+ */
+int scheduler_job_finished_r(scheduler_t * s, int core_id, int job_number, int time_e)
+{
+	//job_t * t_job = (job_t *)priqueue_poll(&cores[core_id].q);
+	job_t * t_job = s->cores[core_id].running_job;
+	s->now = time_e;
+	s->numJobs += 1;
+	s->totalWaitTime += ((time_e - t_job->running_time) - t_job->arrival_time);
+	s->totalRespTime += t_job->start_time - t_job->arrival_time;
+	s->totalTurnTime += time_e - t_job->arrival_time;
+
+	// Return the job to the arena
+	job_release(s, t_job);
+
+	job_t * new_job = next_job(s, core_id);
+	if (new_job == NULL) {
+		s->cores[core_id].idle = true;
+		victim_update(s, core_id);
+		return -1;
+	}
+
+	// set the new running job
+	core_dispatch(s, core_id, new_job, time_e);
+	return new_job->job_id;
+}
+
+
+/**
+  When the scheme is set to RR, called when the quantum timer has expired
+  on a core.
+
+  If any job should be scheduled to run on the core free'd up by
+  the quantum expiration, return the job_number of the job that should be
+  scheduled to run on core core_id.
+
+  @param s the scheduler instance
+  @param core_id the zero-based index of the core where the quantum has expired.
+  @param time the current time of the simulator.
+  @return job_number of the job that should be scheduled on core cord_id
+  @return -1 if core should remain idle
+ */
+int scheduler_quantum_expired_r(scheduler_t * s, int core_id, int time_c)
+{
+	// get the preempted job and set its remaining time
+	job_t * job = s->cores[core_id].running_job;
+	core * owner = (s->queue_mode == QUEUE_PER_CORE) ? &s->cores[core_id] : NULL;
+	job_t * new_job = NULL;
+	s->now = time_c;
+	core_release(s, core_id, time_c);
+	// with nothing else queued on this core, look for a peer's job to steal
+	// before the preempted job is queued and would be picked right back
+	if (owner != NULL && priqueue_size(&owner->run_queue) == 0)
+		new_job = next_job(s, core_id);
+	job_enqueue(s, owner, job);
+	// Check to see if the next job exists
+	if (new_job == NULL)
+		new_job = next_job(s, core_id);
+	if (new_job == NULL) {
+		s->cores[core_id].idle = true;
+		victim_update(s, core_id);
+		return -1;
+	}
+
+	core_dispatch(s, core_id, new_job, time_c);
+	return new_job->job_id;
+}
+
+
+/**
+  Returns the average waiting time of all jobs scheduled by your scheduler.
+
+  Assumptions:
+    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
+  @param s the scheduler instance
+  @return the average waiting time of all jobs scheduled.
+ */
+float scheduler_average_waiting_time_r(scheduler_t * s)
+{
+	float retv = (float)s->totalWaitTime / (float)s->numJobs;
+	return retv;
+}
+
+
+/**
+  Returns the average turnaround time of all jobs scheduled by your scheduler.
+
+  Assumptions:
+    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
+  @param s the scheduler instance
+  @return the average turnaround time of all jobs scheduled.
+ */
+float scheduler_average_turnaround_time_r(scheduler_t * s)
+{
+	float retv = (float)s->totalTurnTime / (float)s->numJobs;
+	return retv;
+}
+
+
+/**
+  Returns the average response time of all jobs scheduled by your scheduler.
+
+  Assumptions:
+    - This function will only be called after all scheduling is complete (all jobs that have arrived will have finished and no new jobs will arrive).
+  @param s the scheduler instance
+  @return the average response time of all jobs scheduled.
+ */
+float scheduler_average_response_time_r(scheduler_t * s)
+{
+	float retv = (float)s->totalRespTime / (float)s->numJobs;
+	return retv;
+}
+
+
+/**
+  Free any memory associated with your scheduler, including the instance itself.
+
+  Assumptions:
+    - This function will be the last function called on the instance.
+  @param s the scheduler instance
+*/
+void scheduler_clean_up_r(scheduler_t * s)
+{
+	for (int i = 0; i < s->NUM_CORES; i ++){
+		s->cores[i].running_job = NULL;
+		if (s->queue_mode == QUEUE_PER_CORE)
+			priqueue_destroy(&s->cores[i].run_queue);
+	}
+	priqueue_destroy(&s->wait_queue);
+	psjf_victims_destroy(&s->psjf_running);
+	pri_victims_destroy(&s->pri_running);
+	free(s->cores);
+	free(s->pending);
+
+	// release every job record at once
+	while (s->job_chunks != NULL) {
+		job_chunk * chunk = s->job_chunks;
+		s->job_chunks = chunk->next;
+		free(chunk);
+	}
+	free(s);
+}
+
+
+/**
+  This function may print out any debugging information you choose. This
+  function will be called by the simulator after every call the simulator
+  makes to your scheduler.
+  In our provided output, we have implemented this function to list the jobs in the order they are to be scheduled.
+	Furthermore, we have also listed the current state of the job (either running on a given core or idle).
+	For example, if we have a non-preemptive algorithm and job(id=4) has began running,
+	job(id=2) arrives with a higher priority, and job(id=1) arrives with a lower priority, the output in our sample output will be:
+
+    2(-1) 4(0) 1(-1)
+
+  This function is not required and will not be graded. You may leave it
+  blank if you do not find it useful.
+  @param s the scheduler instance
+ */
+void scheduler_show_queue_r(scheduler_t * s)
+{
+	printf("RUNNING JOBS:\n");
+	job_t * print_job;
+	for (int i = 0; i < s->NUM_CORES; i++){
+		print_job = s->cores[i].running_job;
+		if (s->cores[i].idle){
+			printf("CORE IS IDLE");
+		}
+		else{
+			printf("Core #%d: job_id: %d  job_priority: %d   remaining_time: %f\n", i, print_job->job_id, print_job->priority, job_remaining(&s->cores[i], s->now));
+		}
+	}
+
+	for (int i = 0; i < ((s->queue_mode == QUEUE_PER_CORE) ? s->NUM_CORES : 1); i++){
+		priqueue_t * queue = (s->queue_mode == QUEUE_PER_CORE) ? &s->cores[i].run_queue : &s->wait_queue;
+		if (s->queue_mode == QUEUE_PER_CORE)
+			printf("\nJOBS IN QUEUE OF CORE #%d:\n", i);
+		else
+			printf("\nJOBS IN QUEUE:\n");
+		if (priqueue_size(queue) <= 0){
+			printf("NO JOBS IN QUEUE\n");
+		}
+		priqueue_iter_t it;
+		priqueue_iter_init(&it, queue);
+		while ((print_job = (job_t *)priqueue_iter_next(&it)) != NULL){
+			printf("job_id: %d   job_priority: %d    remaining_time: %f\n", print_job->job_id, print_job->priority, print_job->remaining_time);
+		}
+		priqueue_iter_destroy(&it);
+	}
+}
+
+
+/**
+  Reports the run queue of a core. In QUEUE_SHARED mode every core reports
+  the length of the shared queue, with no peak or steals recorded.
+
+  @param s the scheduler instance
+  @param core_id the zero-based index of the core
+  @return the core's current and peak queue length and how many jobs it stole
+ */
+core_stats_t scheduler_core_stats_r(scheduler_t * s, int core_id)
+{
+	core_stats_t stats = { priqueue_size(&s->wait_queue), 0, 0 };
+	if (s->queue_mode == QUEUE_PER_CORE){
+		stats.queue_length = priqueue_size(&s->cores[core_id].run_queue);
+		stats.peak_queue_length = s->cores[core_id].peak_queue;
+		stats.steals = s->cores[core_id].steals;
+	}
+	return stats;
+}
+
+
+/*
+ * The original single-instance API, forwarding to default_scheduler.
+ */
+void scheduler_start_up(int cores, scheme_t scheme)
+{
+	default_scheduler = scheduler_start_up_r(cores, scheme);
+}
+
+void scheduler_start_up_mode(int cores, scheme_t scheme, queue_mode_t mode)
+{
+	default_scheduler = scheduler_start_up_mode_r(cores, scheme, mode);
+}
+
+int scheduler_new_job(int job_number, int time, int running_time, int priority)
+{
+	return scheduler_new_job_r(default_scheduler, job_number, time, running_time, priority);
+}
+
+int scheduler_new_jobs(int count, const int * job_numbers, int time, const int * running_times, const int * priorities, int * core_ids)
+{
+	return scheduler_new_jobs_r(default_scheduler, count, job_numbers, time, running_times, priorities, core_ids);
+}
+
+int scheduler_job_finished(int core_id, int job_number, int time)
+{
+	return scheduler_job_finished_r(default_scheduler, core_id, job_number, time);
+}
+
+int scheduler_quantum_expired(int core_id, int time)
+{
+	return scheduler_quantum_expired_r(default_scheduler, core_id, time);
+}
+
+float scheduler_average_turnaround_time()
+{
+	return scheduler_average_turnaround_time_r(default_scheduler);
+}
+
+float scheduler_average_waiting_time()
+{
+	return scheduler_average_waiting_time_r(default_scheduler);
+}
+
+float scheduler_average_response_time()
+{
+	return scheduler_average_response_time_r(default_scheduler);
+}
+
+void scheduler_clean_up()
+{
+	scheduler_clean_up_r(default_scheduler);
+	default_scheduler = NULL;
+}
+
+void scheduler_show_queue()
+{
+	scheduler_show_queue_r(default_scheduler);
+}
+
+core_stats_t scheduler_core_stats(int core_id)
+{
+	return scheduler_core_stats_r(default_scheduler, core_id);
+}
+
+
+/**
+	Helper function to take a job record from the arena and fill it in for
+	a new arrival.
+	@param s the scheduler instance
+	@return the new job, not yet on a core or in the queue
+*/
+job_t * job_create(scheduler_t * s, int job_number, int time, int running_time, int priority)
+{
+	job_t * new_job = job_alloc(s);
+	new_job->job_id = job_number;
+	new_job->arrival_time = time;
+	new_job->running_time = running_time;
+	new_job->remaining_time = running_time;
+	new_job->priority = priority;
+	new_job->start_time = -1;
+
+	// the bucket queue only has levels for 0 .. PRIQUEUE_BUCKET_MAX_LEVELS - 1
+	if (s->queue_kind == PRIQUEUE_BUCKET && (priority < 0 || priority >= PRIQUEUE_BUCKET_MAX_LEVELS))
+		queue_rekey(s);
+	return new_job;
+}
+
+/**
+	Helper function to put a new arrival on an idle core, or on the core of
+	the job it preempts. Leaves the wait queue alone and hands back the job
+	that has to go in it instead.
+	@param s the scheduler instance
+	@param job the arriving job
+	@param time the current time
+	@param waiting set to the job to queue: the arrival itself, the job it
+	preempted, or NULL if it took an idle core
+	@param owner set to the core whose run queue the waiting job joins, or
+	NULL for the shared queue
+	@return index of core job should be scheduled on, or -1
+*/
+int job_place(scheduler_t * s, job_t * job, int time, job_t ** waiting, core ** owner)
+{
+	*waiting = NULL;
+	*owner = NULL;
+
+	//check cores and store
+	for (int i = 0; i < s->NUM_CORES; i++) {
+		// If theres an idle queue add it there and return that core id
+		if(s->cores[i].idle) {
+			core_dispatch(s, i, job, time);
+			return i;
+		}
+	}
+	// if its a preemptive scheme and need to add it to a queue, add it to the shortest queue and return
+	if (s->preemptive){
+		//find least preferential job
+		core * victim = least_preferred_core(s);
+		job_t * temp_job = victim->running_job;
+		int core_to_assign = victim->id;
+
+		// compare against the victim as it stands now; only it might leave its core
+		job_t current = *temp_job;
+		current.remaining_time = job_remaining(victim, time);
+
+		if (s->wait_queue.cmp(job, &current) == -1) {
+			core_release(s, core_to_assign, time);
+			*waiting = temp_job;
+			// the preempted job waits to resume on the core it was running on
+			if (s->queue_mode == QUEUE_PER_CORE)
+				*owner = victim;
+			core_dispatch(s, core_to_assign, job, time);
+			return core_to_assign;
+		}
+	}
+	// if neither of the other two conditions met, it waits in a queue
+	*waiting = job;
+	if (s->queue_mode == QUEUE_PER_CORE)
+		*owner = least_loaded_core(s);
+	return -1;
+}
+
+/**
+	Helper function to add a waiting job to the shared queue, or to a core's
+	run queue, keeping track of the longest that queue has been.
+	@param s the scheduler instance
+	@param owner the core whose run queue gets the job, or NULL for the shared queue
+	@param job the job to queue
+*/
+void job_enqueue(scheduler_t * s, core * owner, job_t * job)
+{
+	if (owner == NULL) {
+		priqueue_offer(&s->wait_queue, job);
+		return;
+	}
+	priqueue_offer(&owner->run_queue, job);
+	if (priqueue_size(&owner->run_queue) > owner->peak_queue)
+		owner->peak_queue = priqueue_size(&owner->run_queue);
+}
+
+/**
+	Helper function to pick the job a core runs next. In QUEUE_PER_CORE mode
+	a core with nothing queued steals the best job of the most loaded peer.
+	@param s the scheduler instance
+	@param core_id the core looking for work
+	@return the job taken from its queue, or NULL if there is none
+*/
+job_t * next_job(scheduler_t * s, int core_id)
+{
+	if (s->queue_mode == QUEUE_SHARED)
+		return (job_t *)priqueue_poll(&s->wait_queue);
+
+	core * c = &s->cores[core_id];
+	if (priqueue_size(&c->run_queue) > 0)
+		return (job_t *)priqueue_poll(&c->run_queue);
+
+	core * peer = most_loaded_core(s, core_id);
+	if (peer == NULL)
+		return NULL;
+	c->steals += 1;
+	return (job_t *)priqueue_poll(&peer->run_queue);
+}
+
+/**
+	Helper function to build an empty wait queue for the active scheme.
+	@param s the scheduler, with determine_cmp() already run
+	@param q the queue to initialize
+	@param cmp the scheme's comparer
+*/
+void queue_init(scheduler_t * s, priqueue_t * q, comparer cmp)
+{
+	switch (s->queue_kind){
+		case PRIQUEUE_BUCKET:
+			priqueue_init_buckets(q, cmp, s->queue_key, PRI_LEVELS);
+			break;
+		case PRIQUEUE_KEYED:
+			priqueue_init_keyed(q, cmp, s->queue_key);
+			break;
+		default:
+			priqueue_init_kind(q, cmp, s->queue_kind);
+			break;
+	}
+}
+
+/**
+	Helper function to move a PRI or PPRI scheduler's queues from bucket
+	queues to keyed heaps, for a priority no bucket level can hold. Jobs
+	are drained in order, so equal priorities keep their order too.
+	@param s the scheduler instance
+*/
+void queue_rekey(scheduler_t * s)
+{
+	s->queue_kind = PRIQUEUE_KEYED;
+	for (int i = -1; i < ((s->queue_mode == QUEUE_PER_CORE) ? s->NUM_CORES : 0); i++) {
+		priqueue_t * q = (i == -1) ? &s->wait_queue : &s->cores[i].run_queue;
+		priqueue_t keyed;
+		queue_init(s, &keyed, q->cmp);
+		priqueue_merge(&keyed, q);
+		priqueue_destroy(q);
+		*q = keyed;
+	}
+}
+
+/**
+	Helper function to find the core with the shortest run queue, the lowest
+	id winning ties. A linear scan; the queue lengths change on nearly every
+	call, so keeping them in a heap would cost as much.
+	@param s the scheduler instance
+	@return the core a new arrival should queue on
+*/
+core * least_loaded_core(scheduler_t * s)
+{
+	core * best = &s->cores[0];
+	for (int i = 1; i < s->NUM_CORES; i++) {
+		if (priqueue_size(&s->cores[i].run_queue) < priqueue_size(&best->run_queue))
+			best = &s->cores[i];
+	}
+	return best;
+}
+
+/**
+	Helper function to find the core with the longest run queue other than
+	core_id, the lowest id winning ties.
+	@param s the scheduler instance
+	@param core_id the core doing the stealing
+	@return the core to steal from, or NULL if every other run queue is empty
+*/
+core * most_loaded_core(scheduler_t * s, int core_id)
+{
+	core * best = NULL;
+	for (int i = 0; i < s->NUM_CORES; i++) {
+		int length = priqueue_size(&s->cores[i].run_queue);
+		if (i != core_id && length > 0 && (best == NULL || length > priqueue_size(&best->run_queue)))
+			best = &s->cores[i];
+	}
+	return best;
+}
+
+/**
+	Helper function to find the core a new arrival would preempt, the one
+	running the least preferred job. Among equally bad jobs the one on the
+	highest core is picked.
+	@param s the scheduler instance
+	@return the core running the least preferred job
+*/
+core * least_preferred_core(scheduler_t * s)
+{
+	if (s->active_scheme == PSJF)
+		return psjf_victims_peek(&s->psjf_running);
+	if (s->active_scheme == PPRI)
+		return pri_victims_peek(&s->pri_running);
+	// RR_cmp keeps every job in place, so the last core is the back
+	return &s->cores[s->NUM_CORES - 1];
+}
+
+/**
+	Helper function to keep a core's place in the victim heap in step with
+	the job it runs. Call it whenever a core gets a new job or goes idle.
+	@param s the scheduler instance
+	@param core_id the core whose job changed
+*/
+void victim_update(scheduler_t * s, int core_id)
+{
+	core * c = &s->cores[core_id];
+
+	if (s->active_scheme == PSJF) {
+		if (c->idle) {
+			if (c->victim_handle != -1)
+				psjf_victims_remove(&s->psjf_running, c->victim_handle);
+			c->victim_handle = -1;
+		} else if (c->victim_handle == -1) {
+			psjf_victims_offer(&s->psjf_running, c);
+		} else {
+			psjf_victims_update(&s->psjf_running, c->victim_handle);
+		}
+	} else if (s->active_scheme == PPRI) {
+		if (c->idle) {
+			if (c->victim_handle != -1)
+				pri_victims_remove(&s->pri_running, c->victim_handle);
+			c->victim_handle = -1;
+		} else if (c->victim_handle == -1) {
+			pri_victims_offer(&s->pri_running, c);
+		} else {
+			pri_victims_update(&s->pri_running, c->victim_handle);
+		}
+	}
+}
+
+/**
+	Helper function to derive how much work the job on a core has left.
+	@param c a busy core
+	@param time the current time
+	@return the running job's remaining time at time
+*/
+float job_remaining(const core * c, float time)
+{
+	return c->running_job->remaining_time - (time - c->dispatch_time);
+}
+
+/**
+	Helper function to put a job on a core, stamping when it started.
+	@param s the scheduler instance
+	@param core_id the core the job runs on
+	@param job the job to run
+	@param time the current time
+*/
+void core_dispatch(scheduler_t * s, int core_id, job_t * job, int time)
+{
+	// If the job doesn't have a start time, give it one
+	if (job->start_time == -1)
+		job->start_time = time;
+	s->cores[core_id].running_job = job;
+	s->cores[core_id].idle = false;
+	s->cores[core_id].dispatch_time = time;
+	victim_update(s, core_id);
+}
+
+/**
+	Helper function to write back the remaining time of the job leaving a
+	core. The core keeps pointing at the job until another is dispatched.
+	@param s the scheduler instance
+	@param core_id the core the job leaves
+	@param time the current time
+*/
+void core_release(scheduler_t * s, int core_id, int time)
+{
+	core * c = &s->cores[core_id];
+	c->running_job->remaining_time = job_remaining(c, time);
+	c->dispatch_time = time;
+}
+
+/**
+	Helper function to take a job record from the arena, growing it by a
+	chunk as large as everything it already owns when no record is free.
+	@param s the scheduler that owns the arena
+	@return an uninitialized job record
+*/
+job_t * job_alloc(scheduler_t * s)
+{
+	if (s->free_jobs == NULL) {
+		int count = (s->pooled_jobs < JOB_CHUNK_MIN) ? JOB_CHUNK_MIN : s->pooled_jobs;
+		job_chunk * chunk = malloc(sizeof(job_chunk) + sizeof(job_t) * count);
+		chunk->count = count;
+		chunk->next = s->job_chunks;
+		s->job_chunks = chunk;
+		// push in reverse so jobs are handed out in address order
+		for (int i = count - 1; i >= 0; i--) {
+			chunk->jobs[i].next_free = s->free_jobs;
+			s->free_jobs = &chunk->jobs[i];
+		}
+		s->pooled_jobs += count;
+	}
+	job_t * job = s->free_jobs;
+	s->free_jobs = job->next_free;
+	return job;
+}
+
+/**
+	Helper function to return a finished job record to the arena
+	@param s the scheduler that owns the arena
+	@param job
+*/
+void job_release(scheduler_t * s, job_t * job)
+{
+	job->next_free = s->free_jobs;
+	s->free_jobs = job;
+}
+
+
+int FCFS_cmp(const void * a, const void * b){
+	int retv;
+	const job_t * job_a = (const job_t *)a;
+	const job_t * job_b = (const job_t *)b;
+
+	if (job_a->arrival_time < job_b->arrival_time){
+		retv = -1;
+	}else if(job_a->arrival_time == job_b->arrival_time){
+		retv = 0;
+	}else{
+		retv = 1;
+	}
+	return retv;
+}
+
+int SJF_cmp(const void * a, const void * b){
+	int retv;
+	const job_t * job_a = (const job_t *)a;
+	const job_t * job_b = (const job_t *)b;
+	if (job_a->running_time < job_b->running_time){
+		retv = -1;
+	}else if(job_a->running_time == job_b->running_time){
+		retv = 0;
+	}else{
+		retv = 1;
+	}
+	return retv;
+}
+
+int PSJF_cmp(const void * a, const void * b){
+	int retv;
+	const job_t * job_a = (const job_t *)a;
+	const job_t * job_b = (const job_t *)b;
+	if (job_a->remaining_time < job_b->remaining_time){
+		retv = -1;
+	}else if(job_a->remaining_time == job_b->remaining_time){
+		retv = 0;
+	}else{
+		retv = 1;
+	}
+	return retv;
+}
+
+int PRI_cmp(const void * a, const void * b){
+	int retv;
+	const job_t * job_a = (const job_t *)a;
+	const job_t * job_b = (const job_t *)b;
+	if (job_a->priority < job_b->priority){
+		retv = -1;
+	}else if(job_a->priority == job_b->priority){
+		retv =  0;
+	}else{
+		retv =  1;
+	}
+	return retv;
+}
+
+// run times are whole time units, so the float fields convert exactly
+int SJF_key(const void * a){
+	return (int)((const job_t *)a)->running_time;
+}
+
+int PSJF_key(const void * a){
+	return (int)((const job_t *)a)->remaining_time;
+}
+
+int PRI_key(const void * a){
+	return ((const job_t *)a)->priority;
+}
+
+int RR_cmp(const void * a, const void * b){
+	return 1;
+}
+
+void increment_timer(int time_c) {
+	time_c++;
+}
@@ -1,25 +1,66 @@
-/** @file libscheduler.h
- */
-
-#include "stdbool.h"
-
-#ifndef LIBSCHEDULER_H_
-#define LIBSCHEDULER_H_
-
-/**
-  Constants which represent the different scheduling algorithms
-*/
-typedef enum {FCFS = 0, SJF, PSJF, PRI, PPRI, RR} scheme_t;
-
-void  scheduler_start_up               (int cores, scheme_t scheme);
-int   scheduler_new_job                (int job_number, int time, int running_time, int priority);
-int   scheduler_job_finished           (int core_id, int job_number, int time);
-int   scheduler_quantum_expired        (int core_id, int time);
-float scheduler_average_turnaround_time();
-float scheduler_average_waiting_time   ();
-float scheduler_average_response_time  ();
-void  scheduler_clean_up               ();
-
-void  scheduler_show_queue             ();
-
-#endif /* LIBSCHEDULER_H_ */
+/** @file libscheduler.h
+ */
+
+#include "stdbool.h"
+
+#ifndef LIBSCHEDULER_H_
+#define LIBSCHEDULER_H_
+
+/**
+  Constants which represent the different scheduling algorithms
+*/
+typedef enum {FCFS = 0, SJF, PSJF, PRI, PPRI, RR} scheme_t;
+
+/**
+  Where waiting jobs are kept: QUEUE_SHARED is one queue every core takes
+  work from. QUEUE_PER_CORE gives each core its own run queue; arrivals
+  join the shortest one and a core whose queue runs dry steals from the
+  longest.
+*/
+typedef enum {QUEUE_SHARED = 0, QUEUE_PER_CORE} queue_mode_t;
+
+/**
+  Run queue statistics of one core, see scheduler_core_stats().
+*/
+typedef struct core_stats_t {
+	int queue_length;
+	int peak_queue_length;
+	int steals;
+} core_stats_t;
+
+/**
+  One independent scheduler. The *_r functions take the instance they work
+  on, so any number of schedulers can run side by side; the functions
+  without the suffix work on a single default instance.
+*/
+typedef struct scheduler_t scheduler_t;
+
+void  scheduler_start_up               (int cores, scheme_t scheme);
+void  scheduler_start_up_mode          (int cores, scheme_t scheme, queue_mode_t mode);
+int   scheduler_new_job                (int job_number, int time, int running_time, int priority);
+int   scheduler_new_jobs               (int count, const int *job_numbers, int time, const int *running_times, const int *priorities, int *core_ids);
+int   scheduler_job_finished           (int core_id, int job_number, int time);
+int   scheduler_quantum_expired        (int core_id, int time);
+float scheduler_average_turnaround_time();
+float scheduler_average_waiting_time   ();
+float scheduler_average_response_time  ();
+void  scheduler_clean_up               ();
+
+void  scheduler_show_queue             ();
+core_stats_t scheduler_core_stats      (int core_id);
+
+scheduler_t * scheduler_start_up_r      (int cores, scheme_t scheme);
+scheduler_t * scheduler_start_up_mode_r (int cores, scheme_t scheme, queue_mode_t mode);
+int   scheduler_new_job_r              (scheduler_t *s, int job_number, int time, int running_time, int priority);
+int   scheduler_new_jobs_r             (scheduler_t *s, int count, const int *job_numbers, int time, const int *running_times, const int *priorities, int *core_ids);
+int   scheduler_job_finished_r         (scheduler_t *s, int core_id, int job_number, int time);
+int   scheduler_quantum_expired_r      (scheduler_t *s, int core_id, int time);
+float scheduler_average_turnaround_time_r(scheduler_t *s);
+float scheduler_average_waiting_time_r (scheduler_t *s);
+float scheduler_average_response_time_r(scheduler_t *s);
+void  scheduler_clean_up_r             (scheduler_t *s);
+
+void  scheduler_show_queue_r           (scheduler_t *s);
+core_stats_t scheduler_core_stats_r    (scheduler_t *s, int core_id);
+
+#endif /* LIBSCHEDULER_H_ */
@@ -0,0 +1,327 @@
+/** @file libtrace.c
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "libtrace.h"
+
+
+/**
+  Parses one integer field starting at *p and moves *p past it and the
+  whitespace around it.  Accepts an optional sign followed by at least one
+  digit, like atoi() but without the locale and errno machinery.  Unlike
+  atoi(), a number outside the range of int is an error rather than
+  wrapping around.
+
+  @return 1 if a number was found, 0 otherwise
+*/
+static int parse_field(const char **p, const char *end, int *value)
+{
+	const char *s = *p;
+	int negative = 0;
+	long long n = 0, limit;
+
+	while (s < end && (*s == ' ' || *s == '\t'))
+		s++;
+
+	if (s < end && (*s == '-' || *s == '+'))
+		negative = (*s++ == '-');
+
+	if (s == end || *s < '0' || *s > '9')
+		return 0;
+
+	limit = negative ? -(long long)INT_MIN : INT_MAX;
+	while (s < end && *s >= '0' && *s <= '9')
+	{
+		n = n * 10 + (*s++ - '0');
+		if (n > limit)
+			return 0;
+	}
+
+	while (s < end && (*s == ' ' || *s == '\t' || *s == '\r'))
+		s++;
+
+	*value = negative ? -n : n;
+	*p = s;
+	return 1;
+}
+
+
+static uint32_t get_le32(const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_le64(const unsigned char *p)
+{
+	return get_le32(p) | ((uint64_t)get_le32(p + 4) << 32);
+}
+
+static void put_le32(unsigned char *p, uint32_t v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+static void put_le64(unsigned char *p, uint64_t v)
+{
+	put_le32(p, v);
+	put_le32(p + 4, v >> 32);
+}
+
+
+/**
+  Reads and checks the header of a binary trace.
+
+  @return 0 if the header is valid and the file holds every record it
+  announces, -2 otherwise.  trace->line counts records in an int, so a
+  header announcing INT_MAX or more records is rejected too.
+*/
+static int open_binary(trace_t *trace)
+{
+	const unsigned char *p = (const unsigned char *)trace->data;
+
+	if (trace->size < TRACE_HEADER_SIZE)
+		return -2;
+
+	memcpy(trace->header.magic, p, 8);
+	trace->header.version = get_le32(p + 8);
+	trace->header.record_size = get_le32(p + 12);
+	trace->header.count = get_le64(p + 16);
+	trace->header.first_arrival = get_le32(p + 24);
+	trace->header.last_arrival = get_le32(p + 28);
+
+	if (trace->header.version != TRACE_VERSION || trace->header.record_size != TRACE_RECORD_SIZE ||
+			trace->header.count > (trace->size - TRACE_HEADER_SIZE) / TRACE_RECORD_SIZE ||
+			trace->header.count >= INT_MAX)
+		return -2;
+
+	trace->format = TRACE_BINARY;
+	trace->pos = TRACE_HEADER_SIZE;
+	trace->line = 0;
+	return 0;
+}
+
+
+/**
+  Opens and maps a trace.  Binary traces (see trace_header_t) are
+  recognised by their magic; anything else is read as CSV in the
+  examples/procN.csv layout: a header line followed by one
+  "arrival time,run time,priority" line per job.
+
+  @param trace a pointer to an instance of trace_t
+  @param file_name the trace to open
+  @return 0 on success, -1 if the file cannot be opened or mapped, -2 if
+  it is a binary trace with an unsupported or truncated header, or with
+  INT_MAX or more records
+*/
+int trace_open(trace_t *trace, const char *file_name)
+{
+	struct stat st;
+
+	trace->data = NULL;
+	trace->size = 0;
+	trace->pos = 0;
+	trace->line = 0;
+	trace->format = TRACE_CSV;
+
+	trace->fd = open(file_name, O_RDONLY);
+	if (trace->fd == -1)
+		return -1;
+
+	if (fstat(trace->fd, &st) == -1)
+	{
+		close(trace->fd);
+		return -1;
+	}
+
+	trace->size = st.st_size;
+	if (trace->size > 0)
+	{
+		void *data = mmap(NULL, trace->size, PROT_READ, MAP_PRIVATE, trace->fd, 0);
+
+		if (data == MAP_FAILED)
+		{
+			close(trace->fd);
+			return -1;
+		}
+
+		madvise(data, trace->size, MADV_SEQUENTIAL);
+		trace->data = data;
+	}
+
+	if (trace->size >= 8 && memcmp(trace->data, TRACE_MAGIC, 8) == 0)
+	{
+		if (open_binary(trace) == -2)
+		{
+			trace_close(trace);
+			return -2;
+		}
+		return 0;
+	}
+
+	// Ignore the first (header) line
+	const char *eol = trace->size ? memchr(trace->data, '\n', trace->size) : NULL;
+	trace->pos = eol ? (size_t)(eol - trace->data) + 1 : trace->size;
+	trace->line = 1;
+
+	return 0;
+}
+
+
+/**
+  Counts the records left in the trace without parsing them.
+
+  @param trace a pointer to an instance of trace_t
+  @return the number of records after the current position: non-blank
+  lines for CSV, from the header for binary traces
+*/
+size_t trace_count(trace_t *trace)
+{
+	const char *s = trace->data + trace->pos, *end = trace->data + trace->size;
+	size_t count = 0;
+
+	if (trace->format == TRACE_BINARY)
+		return trace->header.count - trace->line;
+
+	while (s < end)
+	{
+		const char *eol = memchr(s, '\n', end - s);
+		if (eol == NULL)
+			eol = end;
+
+		while (s < eol && (*s == ' ' || *s == '\t' || *s == '\r'))
+			s++;
+		if (s < eol)
+			count++;
+
+		s = eol + 1;
+	}
+
+	return count;
+}
+
+
+/**
+  Reads the next record of the trace.  Blank lines are skipped and columns
+  after the third are ignored.
+
+  @param trace a pointer to an instance of trace_t
+  @param record filled in with the next job
+  @return 1 if a record was read, 0 at the end of the trace, -1 if the
+  current line is not a valid record (trace->line is its line number, or
+  the record number for binary traces) or is past line INT_MAX
+*/
+int trace_next(trace_t *trace, trace_record_t *record)
+{
+	const char *end = trace->data + trace->size;
+
+	if (trace->format == TRACE_BINARY)
+	{
+		if ((uint64_t)trace->line == trace->header.count)
+			return 0;
+
+		const unsigned char *p = (const unsigned char *)trace->data + trace->pos;
+		record->arrival_time = (int32_t)get_le32(p);
+		record->run_time = (int32_t)get_le32(p + 4);
+		record->priority = (int32_t)get_le32(p + 8);
+
+		trace->pos += TRACE_RECORD_SIZE;
+		trace->line++;
+		return 1;
+	}
+
+	while (trace->pos < trace->size)
+	{
+		const char *s = trace->data + trace->pos;
+		const char *eol = memchr(s, '\n', end - s);
+		if (eol == NULL)
+			eol = end;
+
+		// line numbers are ints; a longer file is reported as a bad line
+		if (trace->line == INT_MAX)
+			return -1;
+
+		trace->pos = (eol - trace->data) + 1;
+		trace->line++;
+
+		while (s < eol && (*s == ' ' || *s == '\t' || *s == '\r'))
+			s++;
+		if (s == eol)
+			continue;
+
+		if (!parse_field(&s, eol, &record->arrival_time) || s == eol || *s++ != ',' ||
+				!parse_field(&s, eol, &record->run_time) || s == eol || *s++ != ',' ||
+				!parse_field(&s, eol, &record->priority) || (s != eol && *s != ','))
+			return -1;
+
+		return 1;
+	}
+
+	return 0;
+}
+
+
+/**
+  Unmaps and closes the trace.
+
+  @param trace a pointer to an instance of trace_t
+*/
+void trace_close(trace_t *trace)
+{
+	if (trace->data)
+		munmap((void *)trace->data, trace->size);
+	close(trace->fd);
+}
+
+
+/**
+  Writes a binary trace header.  Converters write a placeholder first and
+  rewrite it once the count and arrival range are known.
+
+  @param file the binary trace being written
+  @param header the header; magic, version and record_size are filled in
+*/
+void trace_write_header(FILE *file, trace_header_t *header)
+{
+	unsigned char buf[TRACE_HEADER_SIZE];
+
+	memcpy(header->magic, TRACE_MAGIC, 8);
+	header->version = TRACE_VERSION;
+	header->record_size = TRACE_RECORD_SIZE;
+
+	memcpy(buf, header->magic, 8);
+	put_le32(buf + 8, header->version);
+	put_le32(buf + 12, header->record_size);
+	put_le64(buf + 16, header->count);
+	put_le32(buf + 24, header->first_arrival);
+	put_le32(buf + 28, header->last_arrival);
+
+	fwrite(buf, 1, sizeof(buf), file);
+}
+
+
+/**
+  Appends one record to a binary trace.
+
+  @param file the binary trace being written
+  @param record the job to write
+*/
+void trace_write_record(FILE *file, trace_record_t *record)
+{
+	unsigned char buf[TRACE_RECORD_SIZE];
+
+	put_le32(buf, record->arrival_time);
+	put_le32(buf + 4, record->run_time);
+	put_le32(buf + 8, record->priority);
+
+	fwrite(buf, 1, sizeof(buf), file);
+}
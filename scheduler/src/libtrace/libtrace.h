@@ -0,0 +1,72 @@
+/** @file libtrace.h
+ */
+
+#ifndef LIBTRACE_H_
+#define LIBTRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+  Binary traces start with this 8-byte magic followed by a trace_header_t.
+  Every field of the header and of the records is little-endian.
+*/
+#define TRACE_MAGIC "SCHTRACE"
+#define TRACE_VERSION 1
+
+/** Size of a binary record: arrival time, run time and priority as int32 */
+#define TRACE_RECORD_SIZE 12
+
+/**
+  Header of a binary trace, 32 bytes on disk.  first_arrival and
+  last_arrival give the range of arrival times; records are stored in the
+  order they were converted, not necessarily sorted.
+*/
+typedef struct _trace_header_t
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	uint64_t count;
+	int32_t first_arrival, last_arrival;
+} trace_header_t;
+
+#define TRACE_HEADER_SIZE 32
+
+typedef enum { TRACE_CSV = 0, TRACE_BINARY } trace_format_t;
+
+/**
+  One job of a trace, in file order.
+*/
+typedef struct _trace_record_t
+{
+	int arrival_time, run_time, priority;
+} trace_record_t;
+
+/**
+  A trace file mapped into memory and read front to back.  The mapping is
+  file-backed, so pages already consumed can be dropped by the kernel and a
+  trace far larger than memory can be replayed.  CSV and binary traces are
+  told apart by the binary magic; binary records are decoded in place.
+*/
+typedef struct _trace_t
+{
+	int fd;
+	const char *data;
+	size_t size, pos;
+	int line;
+
+	trace_format_t format;
+	trace_header_t header;
+} trace_t;
+
+int    trace_open  (trace_t *trace, const char *file_name);
+size_t trace_count (trace_t *trace);
+int    trace_next  (trace_t *trace, trace_record_t *record);
+void   trace_close (trace_t *trace);
+
+void   trace_write_header (FILE *file, trace_header_t *header);
+void   trace_write_record (FILE *file, trace_record_t *record);
+
+#endif /* LIBTRACE_H_ */
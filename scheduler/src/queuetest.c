@@ -1,74 +1,475 @@
-/** @file queuetest.c
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-
-#include "libpriqueue/libpriqueue.h"
-
-int compare1(const void * a, const void * b)
-{
-	return ( *(int*)a - *(int*)b );
-}
-
-int compare2(const void * a, const void * b)
-{
-	return ( *(int*)b - *(int*)a );
-}
-
-int main()
-{
-	priqueue_t q, q2;
-
-	priqueue_init(&q, compare1);
-	priqueue_init(&q2, compare2);
-
-	/* Pupulate some data... */
-	int *values = malloc(100 * sizeof(int));
-
-	int i;
-	for (i = 0; i < 100; i++)
-		values[i] = i;
-
-	/* Add 5 values, 3 unique. */
-	priqueue_offer(&q, &values[12]);
-	priqueue_offer(&q, &values[13]);
-	priqueue_offer(&q, &values[14]);
-	priqueue_offer(&q, &values[12]);
-	priqueue_offer(&q, &values[12]);
-	printf("Total elements: %d (expected 5).\n", priqueue_size(&q));
-
-	int val = *((int *)priqueue_poll(&q));
-	printf("Top element: %d (expected 12).\n", val);
-	printf("Total elements: %d (expected 4).\n", priqueue_size(&q));
-
-	int vals_removed = priqueue_remove(&q, &values[12]);
-	printf("Elements removed: %d (expected 2).\n", vals_removed);
-	printf("Total elements: %d (expected 2).\n", priqueue_size(&q));
-
-	priqueue_offer(&q, &values[10]);
-	priqueue_offer(&q, &values[30]);
-	priqueue_offer(&q, &values[20]);
-
-	priqueue_offer(&q2, &values[10]);
-	priqueue_offer(&q2, &values[30]);
-	priqueue_offer(&q2, &values[20]);
-
-
-	printf("Elements in order queue (expected 10 13 14 20 30): ");
-	for (i = 0; i < priqueue_size(&q); i++)
-		printf("%d ", *((int *)priqueue_at(&q, i)) );
-	printf("\n");
-
-	printf("Elements in reverse order queue (expected 30 20 10): ");
-	for (i = 0; i < priqueue_size(&q2); i++)
-		printf("%d ", *((int *)priqueue_at(&q2, i)) );
-	printf("\n");
-
-	priqueue_destroy(&q2);
-	priqueue_destroy(&q);
-
-	free(values);
-
-	return 0;
-}
+/** @file queuetest.c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "libpriqueue/libpriqueue.h"
+#include "libpriqueue/libpriqueue_typed.h"
+
+PRIQUEUE_DEFINE(int_queue, int, a < b)
+PRIQUEUE_DEFINE(rev_queue, int *, *a > *b)
+
+typedef struct tracked_t
+{
+	int key;
+	int pos;
+} tracked_t;
+
+PRIQUEUE_DEFINE_INDEXED(tracked_queue, tracked_t *, a->key < b->key, a->pos)
+
+int compare1(const void * a, const void * b)
+{
+	return ( *(int*)a - *(int*)b );
+}
+
+int compare2(const void * a, const void * b)
+{
+	return ( *(int*)b - *(int*)a );
+}
+
+int level1(const void * a)
+{
+	return *(int*)a / 10;
+}
+
+int key1(const void * a)
+{
+	return *(int*)a;
+}
+
+/* Checks that a cursor and a snapshot both visit q in priqueue_at() order. */
+int walk_matches(priqueue_t *q)
+{
+	priqueue_iter_t it;
+	void *snap[64];
+	int n = priqueue_snapshot(q, snap, 64);
+	int ok = (n == priqueue_size(q));
+
+	priqueue_iter_init(&it, q);
+	for (int i = 0; i < n; i++) {
+		if (priqueue_iter_next(&it) != priqueue_at(q, i) || snap[i] != priqueue_at(q, i))
+			ok = 0;
+	}
+	if (priqueue_iter_next(&it) != NULL)
+		ok = 0;
+	priqueue_iter_destroy(&it);
+	return ok;
+}
+
+int main()
+{
+	priqueue_t q, q2;
+
+	priqueue_init(&q, compare1);
+	priqueue_init(&q2, compare2);
+
+	/* Pupulate some data... */
+	int *values = malloc(100 * sizeof(int));
+
+	int i;
+	for (i = 0; i < 100; i++)
+		values[i] = i;
+
+	/* Add 5 values, 3 unique. */
+	priqueue_offer(&q, &values[12]);
+	priqueue_offer(&q, &values[13]);
+	priqueue_offer(&q, &values[14]);
+	priqueue_offer(&q, &values[12]);
+	priqueue_offer(&q, &values[12]);
+	printf("Total elements: %d (expected 5).\n", priqueue_size(&q));
+
+	int val = *((int *)priqueue_poll(&q));
+	printf("Top element: %d (expected 12).\n", val);
+	printf("Total elements: %d (expected 4).\n", priqueue_size(&q));
+
+	int vals_removed = priqueue_remove(&q, &values[12]);
+	printf("Elements removed: %d (expected 2).\n", vals_removed);
+	printf("Total elements: %d (expected 2).\n", priqueue_size(&q));
+
+	priqueue_offer(&q, &values[10]);
+	priqueue_offer(&q, &values[30]);
+	priqueue_offer(&q, &values[20]);
+
+	priqueue_offer(&q2, &values[10]);
+	priqueue_offer(&q2, &values[30]);
+	priqueue_offer(&q2, &values[20]);
+
+
+	printf("Elements in order queue (expected 10 13 14 20 30): ");
+	for (i = 0; i < priqueue_size(&q); i++)
+		printf("%d ", *((int *)priqueue_at(&q, i)) );
+	printf("\n");
+
+	printf("Elements in reverse order queue (expected 30 20 10): ");
+	for (i = 0; i < priqueue_size(&q2); i++)
+		printf("%d ", *((int *)priqueue_at(&q2, i)) );
+	printf("\n");
+
+	printf("Removed at 0: %d (expected 10).\n", *((int *)priqueue_remove_at(&q, 0)));
+	printf("Top element: %d (expected 13).\n", *((int *)priqueue_peek(&q)));
+
+	priqueue_destroy(&q2);
+	priqueue_destroy(&q);
+
+	/* A reserved list queue recycles its pooled nodes. */
+	priqueue_init(&q, compare1);
+	priqueue_reserve(&q, 64);
+	for (i = 0; i < 200; i++) {
+		priqueue_offer(&q, &values[i % 100]);
+		if (i % 3 == 0)
+			priqueue_poll(&q);
+	}
+	printf("Pooled total elements: %d (expected 133).\n", priqueue_size(&q));
+	printf("Pooled top element: %d (expected 33).\n", *((int *)priqueue_peek(&q)));
+	priqueue_destroy(&q);
+
+	/* Same checks against the heap backend. */
+	priqueue_t h;
+	priqueue_init_kind(&h, compare1, PRIQUEUE_HEAP);
+
+	priqueue_offer(&h, &values[12]);
+	priqueue_offer(&h, &values[13]);
+	priqueue_offer(&h, &values[14]);
+	priqueue_offer(&h, &values[12]);
+	priqueue_offer(&h, &values[12]);
+	printf("Heap total elements: %d (expected 5).\n", priqueue_size(&h));
+
+	val = *((int *)priqueue_poll(&h));
+	printf("Heap top element: %d (expected 12).\n", val);
+
+	vals_removed = priqueue_remove(&h, &values[12]);
+	printf("Heap elements removed: %d (expected 2).\n", vals_removed);
+
+	for (i = 40; i > 20; i--)
+		priqueue_offer(&h, &values[i]);
+	priqueue_offer(&h, &values[10]);
+
+	printf("Heap element at 3: %d (expected 21).\n", *((int *)priqueue_at(&h, 3)));
+	printf("Heap removed at 3: %d (expected 21).\n", *((int *)priqueue_remove_at(&h, 3)));
+
+	printf("Heap elements in order (expected 10 13 14 22 ... 40): ");
+	while (priqueue_size(&h) > 0)
+		printf("%d ", *((int *)priqueue_poll(&h)) );
+	printf("\n");
+
+	/* Equal elements must come out in the order they were offered. */
+	int ties[4] = { 5, 5, 5, 5 };
+	for (i = 0; i < 4; i++)
+		priqueue_offer(&h, &ties[i]);
+	printf("Heap tie order (expected 0 1 2 3): ");
+	while (priqueue_size(&h) > 0)
+		printf("%d ", (int)((int *)priqueue_poll(&h) - ties) );
+	printf("\n");
+
+	/* Handles follow their element through the heap. */
+	int keys[6] = { 50, 40, 30, 20, 10, 60 };
+	int handles[6];
+	for (i = 0; i < 6; i++)
+		handles[i] = priqueue_offer_handle(&h, &keys[i]);
+	printf("Heap removed by handle: %d (expected 30).\n", *((int *)priqueue_remove_handle(&h, handles[2])));
+	printf("Heap removed stale handle: %s (expected NULL).\n", priqueue_remove_handle(&h, handles[2]) ? "data" : "NULL");
+	keys[0] = 5;
+	priqueue_update_key(&h, handles[0]);
+	keys[4] = 70;
+	priqueue_update_key(&h, handles[4]);
+	printf("Heap elements after key updates (expected 5 20 40 60 70): ");
+	while (priqueue_size(&h) > 0)
+		printf("%d ", *((int *)priqueue_poll(&h)) );
+	printf("\n");
+	printf("Heap stale handle update: %d (expected -1).\n", priqueue_update_key(&h, handles[2]));
+
+	priqueue_destroy(&h);
+
+	/* The FIFO backend keeps insertion order regardless of the comparer. */
+	priqueue_t f;
+	priqueue_init_kind(&f, compare1, PRIQUEUE_FIFO);
+
+	for (i = 0; i < 40; i++)
+		priqueue_offer(&f, &values[i]);
+	for (i = 0; i < 30; i++)
+		priqueue_poll(&f);
+	for (i = 0; i < 25; i++)
+		priqueue_offer(&f, &values[i]);
+	printf("FIFO total elements: %d (expected 35).\n", priqueue_size(&f));
+	printf("FIFO element at 12: %d (expected 2).\n", *((int *)priqueue_at(&f, 12)));
+	printf("FIFO removed at 1: %d (expected 31).\n", *((int *)priqueue_remove_at(&f, 1)));
+	printf("FIFO removed at 30: %d (expected 21).\n", *((int *)priqueue_remove_at(&f, 30)));
+	vals_removed = priqueue_remove(&f, &values[5]);
+	printf("FIFO elements removed: %d (expected 1).\n", vals_removed);
+
+	printf("FIFO elements in order (expected 30 32 ... 39 0 ... 4 6 ... 20 22 23 24): ");
+	while (priqueue_size(&f) > 0)
+		printf("%d ", *((int *)priqueue_poll(&f)) );
+	printf("\n");
+
+	priqueue_destroy(&f);
+
+	/* The bucket backend orders by level and keeps offer order within one. */
+	priqueue_t b;
+	priqueue_init_buckets(&b, compare1, level1, 2);
+
+	priqueue_offer(&b, &values[15]);
+	priqueue_offer(&b, &values[12]);
+	priqueue_offer(&b, &values[97]);
+	priqueue_offer(&b, &values[3]);
+	priqueue_offer(&b, &values[11]);
+	priqueue_offer(&b, &values[12]);
+	printf("Bucket total elements: %d (expected 6).\n", priqueue_size(&b));
+	printf("Bucket top element: %d (expected 3).\n", *((int *)priqueue_peek(&b)));
+	printf("Bucket element at 4: %d (expected 12).\n", *((int *)priqueue_at(&b, 4)));
+	printf("Bucket removed at 1: %d (expected 15).\n", *((int *)priqueue_remove_at(&b, 1)));
+	vals_removed = priqueue_remove(&b, &values[12]);
+	printf("Bucket elements removed: %d (expected 2).\n", vals_removed);
+
+	printf("Bucket elements in order (expected 3 11 97): ");
+	while (priqueue_size(&b) > 0)
+		printf("%d ", *((int *)priqueue_poll(&b)) );
+	printf("\n");
+
+	priqueue_destroy(&b);
+
+	/* Bucket levels out of range are clamped instead of indexing past the buckets. */
+	int odd_levels[4] = { 1000000000, -5, 3, 2147483647 };
+	priqueue_init_buckets(&b, compare1, key1, 4);
+	printf("Bucket offer into empty queue: %d (expected 0).\n", priqueue_offer(&b, &odd_levels[0]));
+	printf("Bucket offer of a negative level: %d (expected 0).\n", priqueue_offer(&b, &odd_levels[1]));
+	priqueue_offer(&b, &odd_levels[2]);
+	priqueue_offer(&b, &odd_levels[3]);
+	printf("Bucket clamped order (expected -5 3 1000000000 2147483647): ");
+	while (priqueue_size(&b) > 0)
+		printf("%d ", *((int *)priqueue_poll(&b)) );
+	printf("\n");
+	priqueue_destroy(&b);
+
+	/* The keyed heap orders by the inline key and breaks ties by offer order. */
+	priqueue_t k;
+	priqueue_init_keyed(&k, compare1, key1);
+
+	for (i = 0; i < 30; i++)
+		priqueue_offer(&k, &values[(i * 7) % 30]);
+	priqueue_offer_keyed(&k, &ties[0], -5);
+	priqueue_offer_keyed(&k, &ties[1], 4);
+	priqueue_offer_keyed(&k, &ties[2], 4);
+	printf("Keyed total elements: %d (expected 33).\n", priqueue_size(&k));
+	printf("Keyed top element is the negative key: %s (expected yes).\n", priqueue_peek(&k) == &ties[0] ? "yes" : "no");
+	priqueue_poll(&k);
+	printf("Keyed removed at 4: %d (expected 4).\n", *((int *)priqueue_remove_at(&k, 4)));
+	printf("Keyed tie at 4 offered first: %s (expected yes).\n", priqueue_at(&k, 4) == &ties[1] ? "yes" : "no");
+	vals_removed = priqueue_remove(&k, &ties[1]) + priqueue_remove(&k, &ties[2]);
+	printf("Keyed elements removed: %d (expected 2).\n", vals_removed);
+
+	printf("Keyed elements in order (expected 0 1 2 3 5 ... 29): ");
+	while (priqueue_size(&k) > 0)
+		printf("%d ", *((int *)priqueue_poll(&k)) );
+	printf("\n");
+
+	/* Only the plain heap issues handles; a keyed queue refuses and stays empty. */
+	printf("Keyed offer by handle: %d, size %d (expected -1, size 0).\n", priqueue_offer_handle(&k, &values[3]), priqueue_size(&k));
+	printf("Keyed update by handle: %d (expected -1).\n", priqueue_update_key(&k, 0));
+
+	priqueue_destroy(&k);
+
+	/* Ties stay in offer order when the sequence number runs past 32 bits. */
+	priqueue_init_keyed(&k, compare1, key1);
+	k.seq = 0xFFFFFFFFul - 3;
+	for (i = 0; i < 8; i++)
+		priqueue_offer_keyed(&k, &values[i], i % 2);
+	void * wrapped[2] = { &values[0], &values[1] };
+	priqueue_offer_batch(&k, wrapped, 2);
+	printf("Keyed ties across the sequence wrap (expected 0 2 4 6 0 1 3 5 7 1): ");
+	while (priqueue_size(&k) > 0)
+		printf("%d ", *((int *)priqueue_poll(&k)) );
+	printf("\n");
+	priqueue_destroy(&k);
+
+	/* The pairing heap against the sorted list, one random operation at a time. */
+	priqueue_t pl, ph;
+	priqueue_init_kind(&pl, compare1, PRIQUEUE_LIST);
+	priqueue_init_kind(&ph, compare1, PRIQUEUE_PAIRING);
+	priqueue_reserve(&ph, 16);
+	unsigned int lcg = 12345;
+	int agree = 1;
+	for (i = 0; i < 4000; i++) {
+		lcg = lcg * 1103515245 + 12345;
+		int r = (lcg >> 8) % 1000, size = priqueue_size(&pl);
+		if (r < 450 || size == 0) {
+			priqueue_offer(&pl, &values[r % 60]);
+			priqueue_offer(&ph, &values[r % 60]);
+		} else if (r < 700) {
+			agree &= (priqueue_poll(&pl) == priqueue_poll(&ph));
+		} else if (r < 800) {
+			agree &= (priqueue_remove_at(&pl, r % size) == priqueue_remove_at(&ph, r % size));
+		} else if (r < 900) {
+			agree &= (priqueue_remove(&pl, &values[r % 60]) == priqueue_remove(&ph, &values[r % 60]));
+		} else {
+			agree &= (priqueue_at(&pl, r % size) == priqueue_at(&ph, r % size));
+		}
+		agree &= (priqueue_size(&pl) == priqueue_size(&ph) && priqueue_peek(&pl) == priqueue_peek(&ph));
+	}
+	while (priqueue_size(&pl) > 0)
+		agree &= (priqueue_poll(&pl) == priqueue_poll(&ph));
+	printf("Pairing heap agrees with the list: %s (expected yes).\n", agree && priqueue_size(&ph) == 0 ? "yes" : "no");
+
+	/* Merging pairing heaps melds them; other kinds are drained across. */
+	priqueue_t evens;
+	priqueue_init_kind(&evens, compare1, PRIQUEUE_PAIRING);
+	for (i = 0; i < 20; i++) {
+		priqueue_offer(&ph, &values[(i * 7) % 20 * 2 + 1]);
+		priqueue_offer(&evens, &values[(i * 7) % 20 * 2]);
+	}
+	int moved = priqueue_merge(&ph, &evens);
+	printf("Pairing merge moved %d, now %d, left %d (expected 20, 40, 0).\n", moved, priqueue_size(&ph), priqueue_size(&evens));
+	priqueue_offer(&evens, &values[3]);
+	priqueue_merge(&pl, &evens);
+	priqueue_offer(&pl, &values[50]);
+	priqueue_merge(&ph, &pl);
+	printf("Merged elements in order (expected 0 1 2 3 3 4 ... 39 50): ");
+	while (priqueue_size(&ph) > 0)
+		printf("%d ", *((int *)priqueue_poll(&ph)) );
+	printf("\n");
+	priqueue_destroy(&pl);
+	priqueue_destroy(&ph);
+	priqueue_destroy(&evens);
+
+	/* Cursors and snapshots walk every backend in priority order. */
+	priqueue_t walks[6];
+	priqueue_init_kind(&walks[0], compare1, PRIQUEUE_LIST);
+	priqueue_init_kind(&walks[1], compare1, PRIQUEUE_HEAP);
+	priqueue_init_kind(&walks[2], compare1, PRIQUEUE_FIFO);
+	priqueue_init_buckets(&walks[3], compare1, level1, 1);
+	priqueue_init_keyed(&walks[4], compare1, key1);
+	priqueue_init_kind(&walks[5], compare1, PRIQUEUE_PAIRING);
+	for (int w = 0; w < 6; w++) {
+		for (i = 0; i < 40; i++)
+			priqueue_offer(&walks[w], &values[(i * 17) % 40]);
+		priqueue_offer(&walks[w], &values[17]);
+		priqueue_poll(&walks[w]);
+	}
+	printf("Cursor and snapshot match priqueue_at (expected yes yes yes yes yes yes): ");
+	for (int w = 0; w < 6; w++)
+		printf("%s ", walk_matches(&walks[w]) ? "yes" : "no");
+	printf("\n");
+
+	void *first[3];
+	int copied = priqueue_snapshot(&walks[1], first, 3);
+	printf("Heap snapshot of 3: %d %d %d, %d copied (expected 1 2 3, 3 copied).\n",
+			*(int *)first[0], *(int *)first[1], *(int *)first[2], copied);
+	for (int w = 0; w < 6; w++)
+		priqueue_destroy(&walks[w]);
+
+	/* Batch offers and bulk construction match one offer at a time. */
+	void *batch[40];
+	for (i = 0; i < 40; i++)
+		batch[i] = &values[(i * 23) % 20];
+	priqueue_t one[6], many[6];
+	for (int w = 0; w < 6; w++) {
+		priqueue_t *pair[2] = { &one[w], &many[w] };
+		for (int p = 0; p < 2; p++) {
+			if (w == 3)
+				priqueue_init_buckets(pair[p], compare1, level1, 1);
+			else if (w == 4)
+				priqueue_init_keyed(pair[p], compare1, key1);
+			else
+				priqueue_init_kind(pair[p], compare1, (priqueue_kind_t)w);
+		}
+		// the same sequence, the second queue taking a batch no larger than
+		// what it holds and then one larger than it
+		for (i = 0; i < 10; i++) {
+			priqueue_offer(&one[w], &values[i * 3]);
+			priqueue_offer(&many[w], &values[i * 3]);
+		}
+		for (i = 0; i < 40; i++)
+			priqueue_offer(&one[w], batch[i]);
+		priqueue_offer_batch(&many[w], batch, 10);
+		priqueue_offer_batch(&many[w], batch + 10, 0);
+		priqueue_offer_batch(&many[w], batch + 10, 30);
+	}
+	printf("Batch offers match single offers (expected yes yes yes yes yes yes): ");
+	for (int w = 0; w < 6; w++) {
+		int same = (priqueue_size(&one[w]) == priqueue_size(&many[w]));
+		while (same && priqueue_size(&one[w]) > 0)
+			same = (priqueue_poll(&one[w]) == priqueue_poll(&many[w]));
+		printf("%s ", same ? "yes" : "no");
+		priqueue_destroy(&one[w]);
+		priqueue_destroy(&many[w]);
+	}
+	printf("\n");
+
+	priqueue_t built;
+	priqueue_init_from_array(&built, compare1, PRIQUEUE_HEAP, batch, 40);
+	printf("Built heap total elements: %d (expected 40).\n", priqueue_size(&built));
+	printf("Built heap first six (expected 0 0 1 1 2 2): ");
+	for (i = 0; i < 6; i++)
+		printf("%d ", *((int *)priqueue_poll(&built)) );
+	printf("\n");
+	int handle = priqueue_offer_handle(&built, &values[50]);
+	priqueue_offer_handle(&built, &values[51]);
+	printf("Built heap handle removed: %d (expected 50).\n", *((int *)priqueue_remove_handle(&built, handle)));
+	priqueue_destroy(&built);
+
+	priqueue_init_from_array(&built, compare1, PRIQUEUE_FIFO, batch, 40);
+	printf("Built FIFO keeps array order (expected 0 3 6 9): ");
+	for (i = 0; i < 4; i++)
+		printf("%d ", *((int *)priqueue_poll(&built)) );
+	printf("\n");
+	priqueue_destroy(&built);
+
+	/* Typed queues generated by PRIQUEUE_DEFINE. */
+	int_queue t;
+	int_queue_init(&t);
+	for (i = 0; i < 40; i++)
+		int_queue_offer(&t, (i * 13) % 40);
+	printf("Typed total elements: %d (expected 40).\n", int_queue_size(&t));
+	printf("Typed top element: %d (expected 0).\n", int_queue_peek(&t));
+	printf("Typed first five (expected 0 1 2 3 4): ");
+	for (i = 0; i < 5; i++)
+		printf("%d ", int_queue_poll(&t));
+	printf("\n");
+	int_queue_destroy(&t);
+
+	rev_queue r;
+	rev_queue_init(&r);
+	rev_queue_reserve(&r, 8);
+	rev_queue_offer(&r, &values[20]);
+	rev_queue_offer(&r, &ties[0]);
+	rev_queue_offer(&r, &values[30]);
+	rev_queue_offer(&r, &ties[1]);
+	printf("Typed reverse order (expected 30 20 5 5): ");
+	while (rev_queue_size(&r) > 0)
+		printf("%d ", *rev_queue_poll(&r));
+	printf("\n");
+	rev_queue_offer(&r, &ties[1]);
+	rev_queue_offer(&r, &ties[0]);
+	printf("Typed tie order (expected 1 0): %d ", (int)(rev_queue_poll(&r) - ties));
+	printf("%d\n", (int)(rev_queue_poll(&r) - ties));
+	rev_queue_destroy(&r);
+
+	/* Typed queue that keeps each element's position, see PRIQUEUE_DEFINE_INDEXED. */
+	tracked_t tracked[8];
+	tracked_queue tq;
+	int placed = 1;
+	tracked_queue_init(&tq);
+	for (i = 0; i < 8; i++)
+	{
+		tracked[i].key = (i * 5) % 8;
+		tracked_queue_offer(&tq, &tracked[i]);
+	}
+	for (i = 0; i < 8; i++)
+		placed = placed && tq.heap[tracked[i].pos].elem == &tracked[i];
+	printf("Indexed positions tracked: %d (expected 1)\n", placed);
+	tracked[0].key = 100;
+	tracked_queue_update(&tq, tracked[0].pos);
+	tracked[7].key = -1;
+	tracked_queue_update(&tq, tracked[7].pos);
+	printf("Indexed removed key: %d (expected 2)\n", tracked_queue_remove(&tq, tracked[2].pos)->key);
+	printf("Indexed order after updates (expected -1 1 4 5 6 7 100): ");
+	while (tracked_queue_size(&tq) > 0)
+		printf("%d ", tracked_queue_poll(&tq)->key);
+	printf("\n");
+	tracked_queue_destroy(&tq);
+
+	free(values);
+
+	return 0;
+}
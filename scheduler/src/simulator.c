@@ -1,492 +1,991 @@
-/*
- * CS 241
- * The University of Illinois
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <unistd.h>
-#include <string.h>
-#include <assert.h>
-
-#include "libscheduler/libscheduler.h"
-
-
-typedef struct _simulator_job_list_t
-{
-	int job_id, arrival_time, run_time, priority;
-	int core_id, arrived;
-} simulator_job_list_t;
-
-void print_usage(char *program_name)
-{
-	fprintf(stderr, "Usage: %s -c <cores> -s <scheme> <input file>\n", program_name);
-	fprintf(stderr, "       %s -c 2 -s fcfs examples/proc1.csv\n", program_name);
-	fprintf(stderr, "\n");
-	fprintf(stderr, "Acceptable schemes are: fcfs, sjf, psjf, pri, ppri, rr#\n");
-}
-
-int set_active_job(int job_id, int core_id, simulator_job_list_t *jobs, int active_jobs)
-{
-	int i;
-	for (i = 0; i < active_jobs; i++)
-	{
-		if (jobs[i].job_id == job_id && jobs[i].arrived)
-		{
-			jobs[i].core_id = core_id;
-			return 1;
-		}
-	}
-
-	return 0;
-}
-
-void print_available_jobs(simulator_job_list_t *jobs, int active_jobs)
-{
-	printf("Active jobs are: ");
-
-	int i, first = 1;
-	for (i = 0; i < active_jobs; i++)
-	{
-		if (jobs[i].arrived)
-		{
-			if (first)
-			{
-				printf("%d", jobs[i].job_id);
-				first = 0;
-			}
-			else
-				printf(", %d", jobs[i].job_id);
-		}
-	}
-
-	if (!first)
-		printf("\n");
-}
-
-void print_available_cores(int cores)
-{
-	printf("Active cores are: ");
-
-	int i;
-	for (i = 0; i < cores; i++)
-	{
-		if (i == cores - 1)
-			printf("%d\n", i);
-		else
-			printf("%d, ", i);
-	}
-}
-
-
-int main(int argc, char **argv)
-{
-	int c;
-	int cores = 0, scheme = -1, quantum = 0;
-	char *file_name;
-
-	/*
-	 * Parse command line options.
-	 */
-	while ((c = getopt(argc, argv, "c:s:")) != -1)
-	{
-		switch (c)
-		{
-			case 'c':
-				cores = atoi(optarg);
-
-				if (cores <= 0)
-				{
-					fprintf(stderr, "Option -c <cores> require a positive number.\n");
-					print_usage(argv[0]);
-					return 1;
-				}
-				break;
-
-			case 's':
-				if (strcasecmp(optarg, "FCFS") == 0) { scheme = FCFS; }
-				else if (strcasecmp(optarg, "SJF") == 0) { scheme = SJF; }
-				else if (strcasecmp(optarg, "PSJF") == 0) { scheme = PSJF; }
-				else if (strcasecmp(optarg, "PRI") == 0) { scheme = PRI; }
-				else if (strcasecmp(optarg, "PPRI") == 0) { scheme = PPRI; }
-				else if (strncasecmp(optarg, "RR", 2) == 0)
-				{
-					scheme = RR;
-					quantum = atoi(optarg + 2);
-
-					if (quantum <= 0)
-					{
-						fprintf(stderr, "Option -s <scheme> requires a positive number for the quantum of RR. (Eg: -s RR2)\n");
-						print_usage(argv[0]);
-						return 1;
-					}
-				}
-				break;
-
-			case '?':
-				print_usage(argv[0]);
-				return 1;
-
-			default:
-				printf("...\n");
-				break;
-		}
-	}
-
-	if (cores == 0)
-	{
-		fprintf(stderr, "Required option -c <cores> is not present.\n");
-		print_usage(argv[0]);
-		return 1;
-	}
-
-	if (scheme == -1)
-	{
-		fprintf(stderr, "Required option -s <scheme> is not present.\n");
-		print_usage(argv[0]);
-		return 1;
-	}
-
-	if (optind == argc - 1)
-		file_name = argv[optind];
-	else
-	{
-		fprintf(stderr, "A single input file is required.\n");
-		print_usage(argv[0]);
-		return 1;
-	}
-
-
-	/*
-	 * Open the file, read the file, and populate the jobs data structure.
-	 */
-	FILE *file = fopen(file_name, "r");
-	if (file == NULL)
-	{
-		fprintf(stderr, "Unable to open file \"%s\".\n", file_name);
-		return 2;
-	}
-
-
-	int job_id = 0;
-	int jobs_ct = 10;
-	simulator_job_list_t* jobs = malloc(jobs_ct * sizeof(simulator_job_list_t));
-
-	char line[1024 + 1];
-	fgets(line, 1024, file);  // Ignore the first (header) line
-	while (fgets(line, 1024, file) != NULL)
-	{
-		char *arrival_time = strtok(line, ",");
-		char *run_time = strtok(NULL, ",");
-		char *priority = strtok(NULL, ",");
-
-		if (arrival_time != NULL && run_time != NULL && priority != NULL)
-		{
-			if (job_id == jobs_ct)
-			{
-				jobs_ct *= 2;
-				jobs = realloc(jobs, jobs_ct * sizeof(simulator_job_list_t));
-
-				if (!jobs)
-				{
-					fprintf(stderr, "Out of memory.\n");
-					return 2;
-				}
-			}
-
-			jobs[job_id].job_id = job_id;
-			jobs[job_id].arrival_time = atoi(arrival_time);
-			jobs[job_id].run_time = atoi(run_time);
-			jobs[job_id].priority = atoi(priority);
-			jobs[job_id].core_id = -1;
-			jobs[job_id].arrived = 0;
-
-			job_id++;
-		}
-		else
-		{
-			fprintf(stderr, "Illegal file format.\n");
-			return 2;
-		}
-	}
-
-	fclose(file);
-
-
-	/*
-	 * Run the simulation.
-	 */
-
-	printf("Loaded %d core(s) and %d job(s) using ", cores, job_id);
-	if (scheme == FCFS) { printf("First Come First Served (FCFS)"); }
-	else if (scheme == SJF) { printf("Non-preemptive Shortest Job First (SJF)"); }
-	else if (scheme == PSJF) { printf("Preemptive Shortest Job First (PSJF)"); }
-	else if (scheme == PRI) { printf("Non-preemptive Priority (PRI)"); }
-	else if (scheme == PPRI) { printf("Preemptive Priority (PPRI)"); }
-	else if (scheme == RR) { printf("Round Robin (RR) with a quantum of %d", quantum); }
-	printf(" scheduling...\n\n");
-
-	scheduler_start_up(cores, scheme);
-
-
-	int time = 0, i, j;
-	int active_jobs = job_id, jobs_alive = 0;
-
-	int *quantum_clock = malloc(cores * sizeof(int));
-	char **core_timing_diagram = malloc(cores * sizeof(char *));
-	int core_timing_diagram_size = 1024;
-
-	for (i = 0; i < cores; i++)
-	{
-		quantum_clock[i] = -1;
-		core_timing_diagram[i] = malloc(core_timing_diagram_size + 1);
-		core_timing_diagram[i][0] = '\0';
-	}
-
-	while (active_jobs > 0)
-	{
-		printf("=== [TIME %d] ===\n", time);
-
-		/*
-		 * 1. Check if any jobs finished in the last time unit.
-		 */
-		for (i = 0; i < active_jobs; i++)
-		{
-			if (jobs[i].run_time == 0)
-			{
-				// Notify the scheduler has finished
-				int job_id = jobs[i].job_id;
-				int core_id = jobs[i].core_id;
-				int new_job_id = scheduler_job_finished(jobs[i].core_id, jobs[i].job_id, time);
-
-				if (scheme == RR)
-					quantum_clock[jobs[i].core_id] = quantum;
-
-				// Delete the finished jobs, decrease the number of active jobs
-				if (i != active_jobs - 1)
-					memcpy(&jobs[i], &jobs[active_jobs - 1], sizeof(simulator_job_list_t));
-				active_jobs--;
-				jobs_alive--;
-				i--;
-
-				// Set the new job
-				if ( new_job_id != -1 && !set_active_job(new_job_id, core_id, jobs, active_jobs) )
-				{
-					printf("The scheduler_job_finished() selected an invalid job (job_id == %d).\n", new_job_id);
-					print_available_jobs(jobs, active_jobs);
-					return 3;
-				}
-				else
-				{
-					printf("Job %d, running on core %d, finished. Core %d is now running job %d.\n", job_id, core_id, core_id, new_job_id);
-					printf("  Queue: "); scheduler_show_queue(); printf("\n\n");
-				}
-			}
-		}
-
-		/*
-		 * Check to see if we finished our last job.  (If we don't check here, we would run an extra time unit that will be totally idle.)
-		 */
-		if (active_jobs == 0)
-			break;
-
-		/*
-		 * 2. Check of any quantums expired in the last time unit.
-		 */
-		if (scheme == RR)
-		{
-			for (i = 0; i < cores; i++)
-			{
-				if (quantum_clock[i] == 0)
-				{
-					for (j = 0; j < active_jobs; j++)
-					{
-						if (jobs[j].core_id == i)
-						{
-							// Notify the scheduler the quantum has expired
-							int core_id = jobs[j].core_id;
-							int old_job_id = jobs[j].job_id;
-							int new_job_id = scheduler_quantum_expired(jobs[j].core_id, time);
-
-							jobs[j].core_id = -1;
-
-							quantum_clock[core_id] = quantum;
-
-							// Set the new job
-							if ( new_job_id != -1 && !set_active_job(new_job_id, core_id, jobs, active_jobs) )
-							{
-								printf("The scheduler_quantum_expired() selected an invalid job (job_id == %d).\n", new_job_id);
-								print_available_jobs(jobs, active_jobs);
-								return 3;
-							}
-							else
-							{
-								printf("Job %d, running on core %d, had its quantum expire. Core %d is now running job %d.\n", old_job_id, core_id, core_id, new_job_id);
-								printf("  Queue: "); scheduler_show_queue(); printf("\n\n");
-							}
-
-							break;
-						}
-					}
-				}
-			}
-		}
-
-
-		/*
-		 * 3. Check for any new jobs that arrive in this time unit
-		 */
-		for (i = 0; i < active_jobs; i++)
-		{
-			if (jobs[i].arrival_time == time)
-			{
-				int new_job_core_id = scheduler_new_job(jobs[i].job_id, time, jobs[i].run_time, jobs[i].priority);
-				jobs[i].arrived = 1;
-				jobs_alive++;
-
-				if (new_job_core_id >= 0 && new_job_core_id < cores)
-				{
-					printf("A new job, job %d (running time=%d, priority=%d), arrived. Job %d is now running on core %d.\n",
-							jobs[i].job_id, jobs[i].run_time, jobs[i].priority, jobs[i].job_id, new_job_core_id);
-					printf("  Queue: "); scheduler_show_queue(); printf("\n\n");
-
-					// Find if anyone is currently using the core.
-					for (j = 0; j < active_jobs; j++)
-						if (jobs[j].core_id == new_job_core_id)
-							jobs[j].core_id = -1;
-
-					// Assign the core to the new job
-					jobs[i].core_id = new_job_core_id;
-
-					if (scheme == RR)
-						quantum_clock[new_job_core_id] = quantum;
-				}
-				else if (new_job_core_id == -1)
-				{
-					printf("A new job, job %d (running time=%d, priority=%d), arrived. Job %d is set to idle (-1).\n",
-							jobs[i].job_id, jobs[i].run_time, jobs[i].priority, jobs[i].job_id);
-					printf("  Queue: "); scheduler_show_queue(); printf("\n\n");
-				}
-				else
-				{
-					printf("The scheduler_new_job() selected an invalid core (core_id == %d).\n", new_job_core_id);
-					print_available_cores(cores);
-					return 3;
-				}
-			}
-		}
-
-
-		/*
-		 * 4. Run the time unit.
-		 */
-		char time_string[cores][11];
-		int cores_working = 0;
-
-		for (i = 0; i < cores; i++)
-			time_string[i][0] = '\0';
-
-		for (i = 0; i < active_jobs; i++)
-		{
-			if (jobs[i].core_id != -1)
-			{
-				cores_working++;
-				jobs[i].run_time--;
-				quantum_clock[jobs[i].core_id]--;
-
-				assert(time_string[jobs[i].core_id][0] == '\0');
-
-				if (jobs[i].job_id < 10)
-					sprintf(time_string[jobs[i].core_id], "%d", jobs[i].job_id);
-				else if (jobs[i].job_id < 10 + 26)
-					sprintf(time_string[jobs[i].core_id], "%c", jobs[i].job_id - 10 + 'a');
-				else if (jobs[i].job_id < 10 + 26 + 26)
-					sprintf(time_string[jobs[i].core_id], "%c", jobs[i].job_id - 10 - 26 + 'A');
-				else
-					snprintf(time_string[jobs[i].core_id], 10, "(%d)", jobs[i].job_id);
-			}
-		}
-
-		for (i = 0; i < cores; i++)
-		{
-			// If the core is idle, print a '-'
-			if (time_string[i][0] == '\0')
-				strcpy(time_string[i], "-");
-
-			// Ensure we have enough memory
-			while (strlen(core_timing_diagram[i]) + strlen(time_string[i]) >= (unsigned int)core_timing_diagram_size)
-			{
-				core_timing_diagram_size *= 2;
-
-				for (j = 0; j < cores; j++)
-				{
-					core_timing_diagram[j] = realloc(core_timing_diagram[j], core_timing_diagram_size + 1);
-
-					if (core_timing_diagram[j] == NULL)
-					{
-						fprintf(stderr, "Out of memory.\n");
-						return 3;
-					}
-				}
-			}
-
-			strcat( core_timing_diagram[i], time_string[i] );
-		}
-
-
-		/*
-		 * 5. Print data!
-		 */
-		printf("At the end of time unit %d...\n", time);
-
-		for (i = 0; i < cores; i++)
-			printf("  Core %2d: %s\n", i, core_timing_diagram[i]);
-
-		printf("\n");
-
-		printf("  Queue: ");
-		scheduler_show_queue();
-		printf("\n");
-		printf("\n");
-
-
-		/*
-		 * 6. Sanity Checking
-		 *
-		 * - If there's a job alive (needing to be ran) and all CPUs are idle, the scheduler failed to schedule properly.
-		 */
-		if (jobs_alive > 0 && cores_working == 0)
-		{
-			printf("All cores are idle and at least one job remains unscheduled.\n");
-			print_available_jobs(jobs, active_jobs);
-			return 3;
-		}
-
-
-		/*
-		 * 7. Increase time
-		 */
-		time++;
-	}
-
-
-	printf("FINAL TIMING DIAGRAM:\n");
-	for (i = 0; i < cores; i++)
-		printf("  Core %2d: %s\n", i, core_timing_diagram[i]);
-
-	printf("\n");
-	printf("Average Waiting Time: %.2f\n", scheduler_average_waiting_time());
-	printf("Average Turnaround Time: %.2f\n", scheduler_average_turnaround_time());
-	printf("Average Response Time: %.2f\n", scheduler_average_response_time());
-
-	scheduler_clean_up();
-
-
-	free(quantum_clock);
-	for (i=0; i < cores; i++)
-		free(core_timing_diagram[i]);
-	free(core_timing_diagram);
-	free(jobs);
-
-	return 0;
-}
+/*
+ * CS 241
+ * The University of Illinois
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <assert.h>
+
+#include "libscheduler/libscheduler.h"
+#include "libtrace/libtrace.h"
+
+
+/*
+ * The job table is a structure of arrays: one array per field, all indexed by slot.
+ */
+typedef struct _simulator_job_list_t
+{
+	int *job_id, *arrival_time, *run_time, *priority;
+	int *core_id, *arrived;
+} simulator_job_list_t;
+
+/*
+ * Per-core state, also one array per field.  While a job runs, its remaining run time
+ * lives in run_time[core] rather than in the job table, so the tick kernel only touches
+ * these contiguous arrays.
+ */
+typedef struct _simulator_core_list_t
+{
+	int *running, *busy, *run_time;
+} simulator_core_list_t;
+
+/*
+ * One run of a core's timeline: job_id (or -1 for idle) held the core for length
+ * time units starting at start.
+ */
+typedef struct _simulator_segment_t
+{
+	int job_id, start, length;
+} simulator_segment_t;
+
+/*
+ * A core's timing diagram, stored run-length encoded.  Appending a time unit extends
+ * the last segment when the same job keeps the core, so the cost of a trace grows with
+ * the number of context switches rather than with its length.
+ */
+typedef struct _simulator_timeline_t
+{
+	simulator_segment_t *segments;
+	int count, capacity;
+} simulator_timeline_t;
+
+/*
+ * How much the simulator prints: every tick with its queue and timing diagram, only
+ * the scheduling events, or only the final averages.
+ */
+typedef enum { OUTPUT_FULL = 0, OUTPUT_EVENTS, OUTPUT_SUMMARY } simulator_verbosity_t;
+
+/*
+ * stdout is switched to a fully buffered stream of this size, so the per-field
+ * printf()s (including scheduler_show_queue()) land in memory and reach the
+ * terminal or file in large writes.
+ */
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+typedef struct _simulator_arrival_t
+{
+	int arrival_time, job_id;
+} simulator_arrival_t;
+
+/*
+ * Where arrivals come from: the whole trace sorted by arrival time and walked by a
+ * cursor, or, when streaming, the trace itself read one job ahead of the clock.
+ */
+typedef struct _simulator_arrivals_t
+{
+	simulator_arrival_t *sorted;
+	int next, count;
+
+	trace_t *trace;
+	trace_record_t record;
+	int pending;
+} simulator_arrivals_t;
+
+/*
+ * Maps job ids to their slot in the job table.  Ids are handed out in trace order and
+ * an id leaves the map when its job finishes, so the live ids form a window
+ * [base, end) that is kept in a power-of-two ring.  When streaming, memory follows
+ * the oldest unfinished job rather than the length of the trace.
+ */
+typedef struct _simulator_slot_index_t
+{
+	int *slots;
+	int base, end, mask;
+} simulator_slot_index_t;
+
+void print_usage(char *program_name)
+{
+	fprintf(stderr, "Usage: %s -c <cores> -s <scheme> [-e] [-S] [-m] [-v <verbosity>] <input file>\n", program_name);
+	fprintf(stderr, "       %s -c 2 -s fcfs examples/proc1.csv\n", program_name);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Acceptable schemes are: fcfs, sjf, psjf, pri, ppri, rr#\n");
+	fprintf(stderr, "  -e  event-driven: jump straight to the next arrival, completion or quantum expiry\n");
+	fprintf(stderr, "  -S  streaming: read jobs from the trace as they arrive; the trace must be sorted by arrival time\n");
+	fprintf(stderr, "  -m  multi-queue: a run queue per core with work stealing; reports per-core queue lengths and steals\n");
+	fprintf(stderr, "  -v  full (default): every time unit; events: scheduling events only; summary: final averages only\n");
+}
+
+int resize_job_list(simulator_job_list_t *jobs, int jobs_ct)
+{
+	jobs->job_id = realloc(jobs->job_id, jobs_ct * sizeof(int));
+	jobs->arrival_time = realloc(jobs->arrival_time, jobs_ct * sizeof(int));
+	jobs->run_time = realloc(jobs->run_time, jobs_ct * sizeof(int));
+	jobs->priority = realloc(jobs->priority, jobs_ct * sizeof(int));
+	jobs->core_id = realloc(jobs->core_id, jobs_ct * sizeof(int));
+	jobs->arrived = realloc(jobs->arrived, jobs_ct * sizeof(int));
+
+	return jobs->job_id && jobs->arrival_time && jobs->run_time && jobs->priority && jobs->core_id && jobs->arrived;
+}
+
+void free_job_list(simulator_job_list_t *jobs)
+{
+	free(jobs->job_id);
+	free(jobs->arrival_time);
+	free(jobs->run_time);
+	free(jobs->priority);
+	free(jobs->core_id);
+	free(jobs->arrived);
+}
+
+/*
+ * Puts the job in slot onto core_id, loading its remaining run time into the core.
+ */
+void assign_core(simulator_job_list_t *jobs, simulator_core_list_t *core_list, int core_id, int slot)
+{
+	jobs->core_id[slot] = core_id;
+	core_list->running[core_id] = slot;
+	core_list->busy[core_id] = 1;
+	core_list->run_time[core_id] = jobs->run_time[slot];
+}
+
+/*
+ * Takes the job off core_id, saving its remaining run time back to the job table.
+ */
+void release_core(simulator_job_list_t *jobs, simulator_core_list_t *core_list, int core_id)
+{
+	int slot = core_list->running[core_id];
+
+	jobs->run_time[slot] = core_list->run_time[core_id];
+	jobs->core_id[slot] = -1;
+	core_list->running[core_id] = -1;
+	core_list->busy[core_id] = 0;
+	core_list->run_time[core_id] = 0;
+}
+
+/*
+ * Records that job_id (or -1 for idle) held the core for units time units starting at start.
+ */
+int timeline_append(simulator_timeline_t *timeline, int job_id, int start, int units)
+{
+	if (timeline->count > 0)
+	{
+		simulator_segment_t *last = &timeline->segments[timeline->count - 1];
+		if (last->job_id == job_id && last->start + last->length == start)
+		{
+			last->length += units;
+			return 1;
+		}
+	}
+
+	if (timeline->count == timeline->capacity)
+	{
+		int capacity = timeline->capacity ? timeline->capacity * 2 : 16;
+		simulator_segment_t *segments = realloc(timeline->segments, capacity * sizeof(simulator_segment_t));
+
+		if (segments == NULL)
+			return 0;
+
+		timeline->segments = segments;
+		timeline->capacity = capacity;
+	}
+
+	timeline->segments[timeline->count].job_id = job_id;
+	timeline->segments[timeline->count].start = start;
+	timeline->segments[timeline->count].length = units;
+	timeline->count++;
+	return 1;
+}
+
+/*
+ * Renders a timeline as the ASCII timing diagram: one character per time unit, using
+ * 0-9, a-z, A-Z for the first 62 job ids, (id) beyond that and '-' for idle.
+ */
+void print_timeline(simulator_timeline_t *timeline)
+{
+	int i, j;
+	char label[16];
+
+	for (i = 0; i < timeline->count; i++)
+	{
+		int job_id = timeline->segments[i].job_id;
+
+		if (job_id == -1)
+			strcpy(label, "-");
+		else if (job_id < 10)
+			sprintf(label, "%d", job_id);
+		else if (job_id < 10 + 26)
+			sprintf(label, "%c", job_id - 10 + 'a');
+		else if (job_id < 10 + 26 + 26)
+			sprintf(label, "%c", job_id - 10 - 26 + 'A');
+		else
+			sprintf(label, "(%d)", job_id);
+
+		for (j = 0; j < timeline->segments[i].length; j++)
+			fputs(label, stdout);
+	}
+}
+
+/*
+ * Runs every busy core for the given number of time units.  The loop is branch-free
+ * over contiguous int arrays and detects completions with a compare in the same pass.
+ * The arrays never overlap, and saying so lets GCC vectorize the loop without a
+ * runtime alias check (the Makefile builds this file with -O2 -ftree-vectorize).
+ * Returns the number of busy cores and sets *finished when at least one core's job
+ * ran out.
+ */
+int run_cores(int cores, int units, const int *restrict busy, int *restrict run_time, int *restrict quantum_clock, int *finished)
+{
+	int i, working = 0, done = 0;
+
+	for (i = 0; i < cores; i++)
+	{
+		run_time[i] -= units * busy[i];
+		quantum_clock[i] -= units * busy[i];
+		working += busy[i];
+		done |= busy[i] & (run_time[i] == 0);
+	}
+
+	*finished = done;
+	return working;
+}
+
+/*
+ * Returns the slot of job_id, or -1 if it is not a live job.
+ */
+int slot_lookup(simulator_slot_index_t *index, int job_id)
+{
+	if (job_id < index->base || job_id >= index->end)
+		return -1;
+	return index->slots[job_id & index->mask];
+}
+
+void slot_set(simulator_slot_index_t *index, int job_id, int slot)
+{
+	index->slots[job_id & index->mask] = slot;
+}
+
+/*
+ * Adds the next job id (index->end) at the given slot, doubling the ring when full.
+ */
+int slot_add(simulator_slot_index_t *index, int slot)
+{
+	if (index->end - index->base == index->mask + 1)
+	{
+		int capacity = (index->mask + 1) ? (index->mask + 1) * 2 : 16;
+		int *slots = malloc(capacity * sizeof(int));
+		int id;
+
+		if (slots == NULL)
+			return 0;
+
+		for (id = index->base; id < index->end; id++)
+			slots[id & (capacity - 1)] = index->slots[id & index->mask];
+
+		free(index->slots);
+		index->slots = slots;
+		index->mask = capacity - 1;
+	}
+
+	index->slots[index->end & index->mask] = slot;
+	index->end++;
+	return 1;
+}
+
+/*
+ * Drops a finished job, sliding the window past any finished ids at its bottom.
+ */
+void slot_remove(simulator_slot_index_t *index, int job_id)
+{
+	index->slots[job_id & index->mask] = -1;
+	while (index->base < index->end && index->slots[index->base & index->mask] == -1)
+		index->base++;
+}
+
+/*
+ * Returns the arrival time of the next job to arrive, or -1 if there is none.
+ */
+int next_arrival_time(simulator_arrivals_t *arrivals)
+{
+	if (arrivals->trace)
+		return arrivals->pending == 1 ? arrivals->record.arrival_time : -1;
+	return arrivals->next < arrivals->count ? arrivals->sorted[arrivals->next].arrival_time : -1;
+}
+
+/*
+ * Appends a job to the end of the job table, growing it when full.  Returns its slot,
+ * or -1 when out of memory.
+ */
+int add_job(simulator_job_list_t *jobs, int *jobs_ct, int slot, int job_id, trace_record_t *record)
+{
+	if (slot == *jobs_ct)
+	{
+		*jobs_ct *= 2;
+
+		if (!resize_job_list(jobs, *jobs_ct))
+			return -1;
+	}
+
+	jobs->job_id[slot] = job_id;
+	jobs->arrival_time[slot] = record->arrival_time;
+	jobs->run_time[slot] = record->run_time;
+	jobs->priority[slot] = record->priority;
+	jobs->core_id[slot] = -1;
+	jobs->arrived[slot] = 0;
+
+	return slot;
+}
+
+/*
+ * Dispatches job_id onto core_id.  The slot index maps every live job_id to its slot
+ * in jobs, so the lookup is constant-time.
+ */
+int set_active_job(int job_id, int core_id, simulator_job_list_t *jobs, simulator_slot_index_t *slot_index, simulator_core_list_t *core_list)
+{
+	int i = slot_lookup(slot_index, job_id);
+	if (i == -1)
+		return 0;
+
+	if (!jobs->arrived[i])
+		return 0;
+
+	assign_core(jobs, core_list, core_id, i);
+	return 1;
+}
+
+/*
+ * Moves a job to another slot of the job list, keeping the slot index and running set pointing at it.
+ */
+void move_job(simulator_job_list_t *jobs, simulator_slot_index_t *slot_index, simulator_core_list_t *core_list, int from, int to)
+{
+	jobs->job_id[to] = jobs->job_id[from];
+	jobs->arrival_time[to] = jobs->arrival_time[from];
+	jobs->run_time[to] = jobs->run_time[from];
+	jobs->priority[to] = jobs->priority[from];
+	jobs->core_id[to] = jobs->core_id[from];
+	jobs->arrived[to] = jobs->arrived[from];
+
+	slot_set(slot_index, jobs->job_id[to], to);
+	if (jobs->core_id[to] != -1)
+		core_list->running[jobs->core_id[to]] = to;
+}
+
+/*
+ * Without the per-tick headers, events are tagged with the time they happened at.
+ */
+void print_event_time(simulator_verbosity_t verbosity, int time)
+{
+	if (verbosity == OUTPUT_EVENTS)
+		printf("[TIME %d] ", time);
+}
+
+void print_event_queue(simulator_verbosity_t verbosity)
+{
+	if (verbosity == OUTPUT_FULL)
+	{
+		printf("  Queue: ");
+		scheduler_show_queue();
+		printf("\n\n");
+	}
+}
+
+void print_available_jobs(simulator_job_list_t *jobs, int active_jobs)
+{
+	printf("Active jobs are: ");
+
+	int i, first = 1;
+	for (i = 0; i < active_jobs; i++)
+	{
+		if (jobs->arrived[i])
+		{
+			if (first)
+			{
+				printf("%d", jobs->job_id[i]);
+				first = 0;
+			}
+			else
+				printf(", %d", jobs->job_id[i]);
+		}
+	}
+
+	if (!first)
+		printf("\n");
+}
+
+/*
+ * Orders arrivals by time, then by job_id, so jobs arriving on the same tick reach
+ * scheduler_new_job() in trace order.  (A scan of the job table used to hand them
+ * over in slot order, which finished jobs being swapped in from the tail reshuffles.)
+ */
+int compare_arrivals(const void *a, const void *b)
+{
+	const simulator_arrival_t *arrival_a = a, *arrival_b = b;
+
+	if (arrival_a->arrival_time != arrival_b->arrival_time)
+		return (arrival_a->arrival_time < arrival_b->arrival_time) ? -1 : 1;
+	return (arrival_a->job_id > arrival_b->job_id) - (arrival_a->job_id < arrival_b->job_id);
+}
+
+void print_available_cores(int cores)
+{
+	printf("Active cores are: ");
+
+	int i;
+	for (i = 0; i < cores; i++)
+	{
+		if (i == cores - 1)
+			printf("%d\n", i);
+		else
+			printf("%d, ", i);
+	}
+}
+
+
+int main(int argc, char **argv)
+{
+	int c;
+	int cores = 0, scheme = -1, quantum = 0, event_driven = 0, streaming = 0, multi_queue = 0;
+	simulator_verbosity_t verbosity = OUTPUT_FULL;
+	char *file_name;
+
+	/*
+	 * Parse command line options.
+	 */
+	while ((c = getopt(argc, argv, "c:s:eSmv:")) != -1)
+	{
+		switch (c)
+		{
+			case 'c':
+				cores = atoi(optarg);
+
+				if (cores <= 0)
+				{
+					fprintf(stderr, "Option -c <cores> require a positive number.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 's':
+				if (strcasecmp(optarg, "FCFS") == 0) { scheme = FCFS; }
+				else if (strcasecmp(optarg, "SJF") == 0) { scheme = SJF; }
+				else if (strcasecmp(optarg, "PSJF") == 0) { scheme = PSJF; }
+				else if (strcasecmp(optarg, "PRI") == 0) { scheme = PRI; }
+				else if (strcasecmp(optarg, "PPRI") == 0) { scheme = PPRI; }
+				else if (strncasecmp(optarg, "RR", 2) == 0)
+				{
+					scheme = RR;
+					quantum = atoi(optarg + 2);
+
+					if (quantum <= 0)
+					{
+						fprintf(stderr, "Option -s <scheme> requires a positive number for the quantum of RR. (Eg: -s RR2)\n");
+						print_usage(argv[0]);
+						return 1;
+					}
+				}
+				break;
+
+			case 'e':
+				event_driven = 1;
+				break;
+
+			case 'S':
+				streaming = 1;
+				break;
+
+			case 'm':
+				multi_queue = 1;
+				break;
+
+			case 'v':
+				if (strcasecmp(optarg, "full") == 0) { verbosity = OUTPUT_FULL; }
+				else if (strcasecmp(optarg, "events") == 0) { verbosity = OUTPUT_EVENTS; }
+				else if (strcasecmp(optarg, "summary") == 0) { verbosity = OUTPUT_SUMMARY; }
+				else
+				{
+					fprintf(stderr, "Option -v <verbosity> must be one of full, events or summary.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case '?':
+				print_usage(argv[0]);
+				return 1;
+
+			default:
+				printf("...\n");
+				break;
+		}
+	}
+
+	if (cores == 0)
+	{
+		fprintf(stderr, "Required option -c <cores> is not present.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (scheme == -1)
+	{
+		fprintf(stderr, "Required option -s <scheme> is not present.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (optind == argc - 1)
+		file_name = argv[optind];
+	else
+	{
+		fprintf(stderr, "A single input file is required.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+
+	/*
+	 * Open the file, read the file, and populate the jobs data structure.  When
+	 * streaming, only the first job is read here; the rest are read as they arrive.
+	 */
+	trace_t trace;
+	int opened = trace_open(&trace, file_name);
+	if (opened == -1)
+	{
+		fprintf(stderr, "Unable to open file \"%s\".\n", file_name);
+		return 2;
+	}
+	else if (opened == -2)
+	{
+		fprintf(stderr, "Illegal file format.\n");
+		return 2;
+	}
+
+
+	int job_id = 0;
+	int jobs_ct = 10;
+	simulator_job_list_t jobs = { NULL, NULL, NULL, NULL, NULL, NULL };
+	simulator_slot_index_t slot_index = { NULL, 0, 0, -1 };
+	simulator_arrivals_t arrivals = { NULL, 0, 0, NULL, { 0, 0, 0 }, 0 };
+	int total_jobs = -1;
+
+	if (!resize_job_list(&jobs, jobs_ct))
+	{
+		fprintf(stderr, "Out of memory.\n");
+		return 2;
+	}
+
+	if (streaming)
+	{
+		// a binary trace states its length; a CSV trace is not scanned ahead of the run
+		if (trace.format == TRACE_BINARY)
+			total_jobs = trace_count(&trace);
+		arrivals.trace = &trace;
+		arrivals.pending = trace_next(&trace, &arrivals.record);
+	}
+	else
+	{
+		int result;
+		trace_record_t record;
+
+		while ((result = trace_next(&trace, &record)) == 1)
+		{
+			if (job_id == INT_MAX - 1)
+			{
+				fprintf(stderr, "Traces of more than %d jobs are not supported.\n", INT_MAX - 1);
+				return 2;
+			}
+
+			if (add_job(&jobs, &jobs_ct, job_id, job_id, &record) == -1 || !slot_add(&slot_index, job_id))
+			{
+				fprintf(stderr, "Out of memory.\n");
+				return 2;
+			}
+
+			job_id++;
+		}
+
+		arrivals.pending = result;
+		total_jobs = job_id;
+		trace_close(&trace);
+	}
+
+	if (arrivals.pending == -1)
+	{
+		fprintf(stderr, "Illegal file format.\n");
+		return 2;
+	}
+
+
+	/*
+	 * Run the simulation.
+	 */
+
+	setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+	if (verbosity != OUTPUT_SUMMARY)
+	{
+		if (total_jobs == -1)
+			printf("Loaded %d core(s) and a streamed trace using ", cores);
+		else
+			printf("Loaded %d core(s) and %d job(s) using ", cores, total_jobs);
+		if (scheme == FCFS) { printf("First Come First Served (FCFS)"); }
+		else if (scheme == SJF) { printf("Non-preemptive Shortest Job First (SJF)"); }
+		else if (scheme == PSJF) { printf("Preemptive Shortest Job First (PSJF)"); }
+		else if (scheme == PRI) { printf("Non-preemptive Priority (PRI)"); }
+		else if (scheme == PPRI) { printf("Preemptive Priority (PPRI)"); }
+		else if (scheme == RR) { printf("Round Robin (RR) with a quantum of %d", quantum); }
+		printf(" scheduling...\n\n");
+	}
+
+	scheduler_start_up_mode(cores, scheme, multi_queue ? QUEUE_PER_CORE : QUEUE_SHARED);
+
+
+	int time = 0, i;
+	int active_jobs = job_id, jobs_alive = 0;
+
+	/*
+	 * Without streaming, the jobs in order of arrival, walked by a cursor as time
+	 * advances.  The slot index maps a job_id to its current slot in jobs, which moves
+	 * as finished jobs are removed, and core_list.running[c] is the slot of the job on
+	 * core c, or -1.
+	 */
+	if (!streaming)
+	{
+		arrivals.sorted = malloc((job_id + 1) * sizeof(simulator_arrival_t));
+		arrivals.count = job_id;
+		for (i = 0; i < job_id; i++)
+		{
+			arrivals.sorted[i].arrival_time = jobs.arrival_time[i];
+			arrivals.sorted[i].job_id = jobs.job_id[i];
+		}
+		qsort(arrivals.sorted, job_id, sizeof(simulator_arrival_t), compare_arrivals);
+	}
+
+	simulator_core_list_t core_list;
+	core_list.running = malloc(cores * sizeof(int));
+	core_list.busy = malloc(cores * sizeof(int));
+	core_list.run_time = malloc(cores * sizeof(int));
+	int jobs_finished = 0;
+
+	int *quantum_clock = malloc(cores * sizeof(int));
+	simulator_timeline_t *core_timeline = calloc(cores, sizeof(simulator_timeline_t));
+
+	for (i = 0; i < cores; i++)
+	{
+		core_list.running[i] = -1;
+		core_list.busy[i] = 0;
+		core_list.run_time[i] = 0;
+		quantum_clock[i] = -1;
+	}
+
+	while (active_jobs > 0 || next_arrival_time(&arrivals) != -1)
+	{
+		if (verbosity == OUTPUT_FULL)
+			printf("=== [TIME %d] ===\n", time);
+
+		/*
+		 * 1. Check if any jobs finished in the last time unit.  Only running jobs can
+		 *    finish.  They are handled in job_id order, like same-tick arrivals, so the
+		 *    order does not depend on where a job sits in the job table, which differs
+		 *    between streaming and loading the whole trace.
+		 */
+		while (jobs_finished)
+		{
+			int core_id = -1;
+			for (i = 0; i < cores; i++)
+			{
+				if (core_list.busy[i] && core_list.run_time[i] == 0 &&
+						(core_id == -1 || jobs.job_id[core_list.running[i]] < jobs.job_id[core_list.running[core_id]]))
+					core_id = i;
+			}
+
+			if (core_id == -1)
+			{
+				jobs_finished = 0;
+				break;
+			}
+
+			// Notify the scheduler has finished
+			int slot = core_list.running[core_id];
+			int job_id = jobs.job_id[slot];
+			int new_job_id = scheduler_job_finished(core_id, job_id, time);
+
+			if (scheme == RR)
+				quantum_clock[core_id] = quantum;
+
+			// Delete the finished jobs, decrease the number of active jobs
+			release_core(&jobs, &core_list, core_id);
+			slot_remove(&slot_index, job_id);
+			if (slot != active_jobs - 1)
+				move_job(&jobs, &slot_index, &core_list, active_jobs - 1, slot);
+			active_jobs--;
+			jobs_alive--;
+
+			// Set the new job
+			if ( new_job_id != -1 && !set_active_job(new_job_id, core_id, &jobs, &slot_index, &core_list) )
+			{
+				printf("The scheduler_job_finished() selected an invalid job (job_id == %d).\n", new_job_id);
+				print_available_jobs(&jobs, active_jobs);
+				return 3;
+			}
+			else if (verbosity != OUTPUT_SUMMARY)
+			{
+				print_event_time(verbosity, time);
+				printf("Job %d, running on core %d, finished. Core %d is now running job %d.\n", job_id, core_id, core_id, new_job_id);
+				print_event_queue(verbosity);
+			}
+		}
+
+		/*
+		 * Check to see if we finished our last job.  (If we don't check here, we would run an extra time unit that will be totally idle.)
+		 */
+		if (active_jobs == 0 && next_arrival_time(&arrivals) == -1)
+			break;
+
+		/*
+		 * 2. Check of any quantums expired in the last time unit.
+		 */
+		if (scheme == RR)
+		{
+			for (i = 0; i < cores; i++)
+			{
+				if (quantum_clock[i] == 0 && core_list.busy[i])
+				{
+					// Notify the scheduler the quantum has expired
+					int core_id = i;
+					int old_job_id = jobs.job_id[core_list.running[i]];
+					int new_job_id = scheduler_quantum_expired(core_id, time);
+
+					release_core(&jobs, &core_list, core_id);
+
+					quantum_clock[core_id] = quantum;
+
+					// Set the new job
+					if ( new_job_id != -1 && !set_active_job(new_job_id, core_id, &jobs, &slot_index, &core_list) )
+					{
+						printf("The scheduler_quantum_expired() selected an invalid job (job_id == %d).\n", new_job_id);
+						print_available_jobs(&jobs, active_jobs);
+						return 3;
+					}
+					else if (verbosity != OUTPUT_SUMMARY)
+					{
+						print_event_time(verbosity, time);
+						printf("Job %d, running on core %d, had its quantum expire. Core %d is now running job %d.\n", old_job_id, core_id, core_id, new_job_id);
+						print_event_queue(verbosity);
+					}
+				}
+			}
+		}
+
+
+		/*
+		 * 3. Check for any new jobs that arrive in this time unit, in job_id order
+		 */
+		while (next_arrival_time(&arrivals) == time)
+		{
+			if (streaming)
+			{
+				if (job_id == INT_MAX - 1)
+				{
+					fprintf(stderr, "Traces of more than %d jobs are not supported.\n", INT_MAX - 1);
+					return 2;
+				}
+
+				i = add_job(&jobs, &jobs_ct, active_jobs, job_id, &arrivals.record);
+				if (i == -1 || !slot_add(&slot_index, i))
+				{
+					fprintf(stderr, "Out of memory.\n");
+					return 2;
+				}
+
+				active_jobs++;
+				job_id++;
+
+				arrivals.pending = trace_next(&trace, &arrivals.record);
+				if (arrivals.pending == -1)
+				{
+					fprintf(stderr, "Illegal file format (line %d).\n", trace.line);
+					return 2;
+				}
+				if (arrivals.pending == 1 && arrivals.record.arrival_time < time)
+				{
+					fprintf(stderr, "Streaming requires a trace sorted by arrival time (line %d).\n", trace.line);
+					return 2;
+				}
+			}
+			else
+				i = slot_lookup(&slot_index, arrivals.sorted[arrivals.next++].job_id);
+
+			int new_job_core_id = scheduler_new_job(jobs.job_id[i], time, jobs.run_time[i], jobs.priority[i]);
+			jobs.arrived[i] = 1;
+			jobs_alive++;
+
+			if (new_job_core_id >= 0 && new_job_core_id < cores)
+			{
+				if (verbosity != OUTPUT_SUMMARY)
+				{
+					print_event_time(verbosity, time);
+					printf("A new job, job %d (running time=%d, priority=%d), arrived. Job %d is now running on core %d.\n",
+							jobs.job_id[i], jobs.run_time[i], jobs.priority[i], jobs.job_id[i], new_job_core_id);
+					print_event_queue(verbosity);
+				}
+
+				// Find if anyone is currently using the core.
+				if (core_list.busy[new_job_core_id])
+					release_core(&jobs, &core_list, new_job_core_id);
+
+				// Assign the core to the new job
+				assign_core(&jobs, &core_list, new_job_core_id, i);
+
+				if (scheme == RR)
+					quantum_clock[new_job_core_id] = quantum;
+			}
+			else if (new_job_core_id == -1)
+			{
+				if (verbosity != OUTPUT_SUMMARY)
+				{
+					print_event_time(verbosity, time);
+					printf("A new job, job %d (running time=%d, priority=%d), arrived. Job %d is set to idle (-1).\n",
+							jobs.job_id[i], jobs.run_time[i], jobs.priority[i], jobs.job_id[i]);
+					print_event_queue(verbosity);
+				}
+			}
+			else
+			{
+				printf("The scheduler_new_job() selected an invalid core (core_id == %d).\n", new_job_core_id);
+				print_available_cores(cores);
+				return 3;
+			}
+		}
+
+
+		/*
+		 * 4. Run the time unit.  In event-driven mode, run every unit up to the
+		 *    next arrival, completion or quantum expiry at once; nothing can
+		 *    change in between.
+		 */
+		int cores_working = 0;
+		int units = 1;
+
+		if (event_driven)
+		{
+			units = next_arrival_time(&arrivals);
+			if (units != -1)
+				units -= time;
+
+			for (i = 0; i < cores; i++)
+			{
+				if (core_list.busy[i])
+				{
+					if (units == -1 || core_list.run_time[i] < units)
+						units = core_list.run_time[i];
+					if (scheme == RR && quantum_clock[i] < units)
+						units = quantum_clock[i];
+				}
+			}
+
+			if (units < 1)
+				units = 1;
+		}
+
+		cores_working = run_cores(cores, units, core_list.busy, core_list.run_time, quantum_clock, &jobs_finished);
+
+		for (i = 0; i < cores; i++)
+		{
+			int job_id = -1;
+
+			if (core_list.busy[i])
+			{
+				job_id = jobs.job_id[core_list.running[i]];
+				assert(jobs.core_id[core_list.running[i]] == i);
+			}
+
+			if (!timeline_append(&core_timeline[i], job_id, time, units))
+			{
+				fprintf(stderr, "Out of memory.\n");
+				return 3;
+			}
+		}
+
+
+		/*
+		 * 5. Print data!
+		 */
+		if (verbosity == OUTPUT_FULL)
+		{
+			printf("At the end of time unit %d...\n", time + units - 1);
+
+			for (i = 0; i < cores; i++)
+			{
+				printf("  Core %2d: ", i);
+				print_timeline(&core_timeline[i]);
+				printf("\n");
+			}
+
+			printf("\n");
+
+			printf("  Queue: ");
+			scheduler_show_queue();
+			printf("\n");
+			printf("\n");
+		}
+
+
+		/*
+		 * 6. Sanity Checking
+		 *
+		 * - If there's a job alive (needing to be ran) and all CPUs are idle, the scheduler failed to schedule properly.
+		 */
+		if (jobs_alive > 0 && cores_working == 0)
+		{
+			printf("All cores are idle and at least one job remains unscheduled.\n");
+			print_available_jobs(&jobs, active_jobs);
+			return 3;
+		}
+
+
+		/*
+		 * 7. Increase time
+		 */
+		time += units;
+	}
+
+
+	if (verbosity != OUTPUT_SUMMARY)
+	{
+		printf("FINAL TIMING DIAGRAM:\n");
+		for (i = 0; i < cores; i++)
+		{
+			printf("  Core %2d: ", i);
+			print_timeline(&core_timeline[i]);
+			printf("\n");
+		}
+
+		printf("\n");
+	}
+	printf("Average Waiting Time: %.2f\n", scheduler_average_waiting_time());
+	printf("Average Turnaround Time: %.2f\n", scheduler_average_turnaround_time());
+	printf("Average Response Time: %.2f\n", scheduler_average_response_time());
+
+	if (multi_queue)
+	{
+		printf("\nRun queues:\n");
+		for (i = 0; i < cores; i++)
+		{
+			core_stats_t stats = scheduler_core_stats(i);
+			printf("  Core %2d: peak length %d, %d job(s) stolen\n", i, stats.peak_queue_length, stats.steals);
+		}
+	}
+
+	scheduler_clean_up();
+
+
+	if (streaming)
+		trace_close(&trace);
+	free(arrivals.sorted);
+	free(slot_index.slots);
+	free(core_list.running);
+	free(core_list.busy);
+	free(core_list.run_time);
+	free(quantum_clock);
+	for (i=0; i < cores; i++)
+		free(core_timeline[i].segments);
+	free(core_timeline);
+	free_job_list(&jobs);
+
+	return 0;
+}
@@ -0,0 +1,557 @@
+/*
+ * Runs a whole grid of simulations -- every scheme, core count and RR quantum
+ * asked for, over one or more traces -- on a pool of threads and prints one
+ * table with the three averages of each run.  Each trace is loaded once and
+ * shared read-only by every run; each run has its own scheduler_t.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "libscheduler/libscheduler.h"
+#include "libtrace/libtrace.h"
+
+
+#define MAX_GRID 64
+
+/*
+ * A trace loaded once and shared by every run: the jobs by job_id and the job_ids
+ * in order of arrival.
+ */
+typedef struct _sweep_trace_t
+{
+	const char *file_name;
+	int count;
+	int *arrival_time, *run_time, *priority;
+	int *order;
+} sweep_trace_t;
+
+/*
+ * One cell of the grid and, once a worker has run it, its averages.
+ */
+typedef struct _sweep_run_t
+{
+	const sweep_trace_t *trace;
+	int cores, scheme, quantum;
+	queue_mode_t mode;
+
+	int status;
+	float waiting, turnaround, response;
+} sweep_run_t;
+
+typedef struct _sweep_pool_t
+{
+	sweep_run_t *runs;
+	int count, next;
+	pthread_mutex_t lock;
+} sweep_pool_t;
+
+enum { RUN_PENDING = 0, RUN_OK, RUN_FAILED };
+
+const char *scheme_names[] = { "fcfs", "sjf", "psjf", "pri", "ppri", "rr" };
+
+
+typedef struct _sweep_arrival_t
+{
+	int arrival_time, job_id;
+} sweep_arrival_t;
+
+/*
+ * Orders arrivals by time, then by job_id, as the simulator does.
+ */
+int compare_arrivals(const void *a, const void *b)
+{
+	const sweep_arrival_t *arrival_a = a, *arrival_b = b;
+
+	if (arrival_a->arrival_time != arrival_b->arrival_time)
+		return (arrival_a->arrival_time < arrival_b->arrival_time) ? -1 : 1;
+	return (arrival_a->job_id > arrival_b->job_id) - (arrival_a->job_id < arrival_b->job_id);
+}
+
+int load_trace(sweep_trace_t *trace, const char *file_name)
+{
+	trace_t file;
+	trace_record_t record;
+	int result, capacity = 16;
+
+	if (trace_open(&file, file_name) != 0)
+		return 0;
+
+	trace->file_name = file_name;
+	trace->count = 0;
+	trace->arrival_time = malloc(capacity * sizeof(int));
+	trace->run_time = malloc(capacity * sizeof(int));
+	trace->priority = malloc(capacity * sizeof(int));
+
+	while ((result = trace_next(&file, &record)) == 1)
+	{
+		if (trace->count == capacity)
+		{
+			capacity *= 2;
+			trace->arrival_time = realloc(trace->arrival_time, capacity * sizeof(int));
+			trace->run_time = realloc(trace->run_time, capacity * sizeof(int));
+			trace->priority = realloc(trace->priority, capacity * sizeof(int));
+		}
+
+		trace->arrival_time[trace->count] = record.arrival_time;
+		trace->run_time[trace->count] = record.run_time;
+		trace->priority[trace->count] = record.priority;
+		trace->count++;
+	}
+
+	trace_close(&file);
+	if (result == -1)
+		return 0;
+
+	int i;
+	sweep_arrival_t *sorted = malloc((trace->count + 1) * sizeof(sweep_arrival_t));
+	for (i = 0; i < trace->count; i++)
+	{
+		sorted[i].arrival_time = trace->arrival_time[i];
+		sorted[i].job_id = i;
+	}
+	qsort(sorted, trace->count, sizeof(sweep_arrival_t), compare_arrivals);
+
+	trace->order = malloc((trace->count + 1) * sizeof(int));
+	for (i = 0; i < trace->count; i++)
+		trace->order[i] = sorted[i].job_id;
+	free(sorted);
+
+	return 1;
+}
+
+void free_trace(sweep_trace_t *trace)
+{
+	free(trace->arrival_time);
+	free(trace->run_time);
+	free(trace->priority);
+	free(trace->order);
+}
+
+
+/*
+ * Replays the trace against a fresh scheduler, as the simulator does in
+ * event-driven mode but without any output.  Same-time completions and arrivals are
+ * both handled in job_id order, exactly like the simulator, so the averages match
+ * its -v summary output (examples.pl checks that they do).
+ */
+int replay(sweep_run_t *run)
+{
+	const sweep_trace_t *trace = run->trace;
+	int cores = run->cores, quantum = run->quantum, n = trace->count;
+	int *remaining = malloc((n + 1) * sizeof(int));
+	int *live = calloc(n + 1, sizeof(int));
+	int *running = malloc(cores * sizeof(int));
+	int *quantum_clock = malloc(cores * sizeof(int));
+	int *burst_run_time = malloc((n + 1) * sizeof(int));
+	int *burst_priority = malloc((n + 1) * sizeof(int));
+	int *burst_core = malloc((n + 1) * sizeof(int));
+	int active_jobs = n, jobs_alive = 0, next_arrival = 0, time = 0, ok = 1;
+	int i;
+
+	scheduler_t *s = scheduler_start_up_mode_r(cores, run->scheme, run->mode);
+
+	for (i = 0; i < n; i++)
+		remaining[i] = trace->run_time[i];
+	for (i = 0; i < cores; i++)
+	{
+		running[i] = -1;
+		quantum_clock[i] = -1;
+	}
+
+	while (ok && active_jobs > 0)
+	{
+		// 1. Finished jobs, in job_id order
+		while (1)
+		{
+			int core_id = -1;
+			for (i = 0; i < cores; i++)
+			{
+				if (running[i] != -1 && remaining[running[i]] == 0 &&
+						(core_id == -1 || running[i] < running[core_id]))
+					core_id = i;
+			}
+
+			if (core_id == -1)
+				break;
+
+			int job_id = running[core_id];
+			int new_job_id = scheduler_job_finished_r(s, core_id, job_id, time);
+
+			if (run->scheme == RR)
+				quantum_clock[core_id] = quantum;
+
+			live[job_id] = 0;
+			running[core_id] = -1;
+			active_jobs--;
+			jobs_alive--;
+
+			if (new_job_id != -1)
+			{
+				if (new_job_id < 0 || new_job_id >= n || !live[new_job_id])
+				{
+					ok = 0;
+					break;
+				}
+				running[core_id] = new_job_id;
+			}
+		}
+
+		if (!ok || active_jobs == 0)
+			break;
+
+		// 2. Expired quanta
+		if (run->scheme == RR)
+		{
+			for (i = 0; i < cores; i++)
+			{
+				if (quantum_clock[i] == 0 && running[i] != -1)
+				{
+					int new_job_id = scheduler_quantum_expired_r(s, i, time);
+
+					quantum_clock[i] = quantum;
+					if (new_job_id != -1 && (new_job_id < 0 || new_job_id >= n || !live[new_job_id]))
+						ok = 0;
+					running[i] = new_job_id;
+				}
+			}
+		}
+
+		// 3. Arrivals, every job of this time unit in one burst
+		int burst = 0;
+		const int *burst_job = trace->order + next_arrival;
+		while (next_arrival + burst < n && trace->arrival_time[burst_job[burst]] == time)
+		{
+			burst_run_time[burst] = trace->run_time[burst_job[burst]];
+			burst_priority[burst] = trace->priority[burst_job[burst]];
+			burst++;
+		}
+
+		if (ok && burst > 0)
+		{
+			scheduler_new_jobs_r(s, burst, burst_job, time, burst_run_time, burst_priority, burst_core);
+			next_arrival += burst;
+			jobs_alive += burst;
+
+			for (i = 0; i < burst; i++)
+			{
+				int core_id = burst_core[i];
+
+				live[burst_job[i]] = 1;
+				if (core_id >= 0 && core_id < cores)
+				{
+					running[core_id] = burst_job[i];
+					if (run->scheme == RR)
+						quantum_clock[core_id] = quantum;
+				}
+				else if (core_id != -1)
+					ok = 0;
+			}
+		}
+
+		if (!ok)
+			break;
+
+		// 4. Run up to the next arrival, completion or quantum expiry
+		int units = (next_arrival < n) ? trace->arrival_time[trace->order[next_arrival]] - time : -1;
+		int cores_working = 0;
+
+		for (i = 0; i < cores; i++)
+		{
+			if (running[i] != -1)
+			{
+				if (units == -1 || remaining[running[i]] < units)
+					units = remaining[running[i]];
+				if (run->scheme == RR && quantum_clock[i] < units)
+					units = quantum_clock[i];
+			}
+		}
+
+		if (units < 1)
+			units = 1;
+
+		for (i = 0; i < cores; i++)
+		{
+			if (running[i] != -1)
+			{
+				remaining[running[i]] -= units;
+				quantum_clock[i] -= units;
+				cores_working++;
+			}
+		}
+
+		if (jobs_alive > 0 && cores_working == 0)
+			ok = 0;
+
+		time += units;
+	}
+
+	if (ok)
+	{
+		run->waiting = scheduler_average_waiting_time_r(s);
+		run->turnaround = scheduler_average_turnaround_time_r(s);
+		run->response = scheduler_average_response_time_r(s);
+	}
+	run->status = ok ? RUN_OK : RUN_FAILED;
+
+	scheduler_clean_up_r(s);
+	free(remaining);
+	free(live);
+	free(running);
+	free(quantum_clock);
+	free(burst_run_time);
+	free(burst_priority);
+	free(burst_core);
+
+	return ok;
+}
+
+void *worker(void *arg)
+{
+	sweep_pool_t *pool = arg;
+
+	while (1)
+	{
+		pthread_mutex_lock(&pool->lock);
+		int next = pool->next++;
+		pthread_mutex_unlock(&pool->lock);
+
+		if (next >= pool->count)
+			return NULL;
+
+		replay(&pool->runs[next]);
+	}
+}
+
+
+/*
+ * Parses a comma separated list of positive numbers.  Returns how many were read,
+ * or 0 if the list is malformed.
+ */
+int parse_list(const char *list, int *values, int max)
+{
+	int count = 0;
+
+	while (*list)
+	{
+		char *end;
+		long value = strtol(list, &end, 10);
+
+		if (end == list || value <= 0 || count == max)
+			return 0;
+
+		values[count++] = value;
+		list = (*end == ',') ? end + 1 : end;
+		if (*end != ',' && *end != '\0')
+			return 0;
+	}
+
+	return count;
+}
+
+int parse_schemes(const char *list, int *schemes)
+{
+	int count = 0;
+	char buf[256];
+	char *save, *name;
+
+	snprintf(buf, sizeof(buf), "%s", list);
+	for (name = strtok_r(buf, ",", &save); name != NULL; name = strtok_r(NULL, ",", &save))
+	{
+		int scheme;
+
+		for (scheme = FCFS; scheme <= RR; scheme++)
+			if (strcasecmp(name, scheme_names[scheme]) == 0)
+				break;
+
+		if (scheme > RR || count == RR + 1)
+			return 0;
+		schemes[count++] = scheme;
+	}
+
+	return count;
+}
+
+void print_usage(char *program_name)
+{
+	fprintf(stderr, "Usage: %s [-s <schemes>] [-c <cores>] [-q <quanta>] [-j <threads>] [-m] [-o <output file>] <trace> [<trace> ...]\n", program_name);
+	fprintf(stderr, "       %s -s fcfs,sjf,rr -c 1,2,4 -q 1,2,4 examples/proc1.csv examples/proc2.csv\n", program_name);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "  -s  schemes to run, from fcfs, sjf, psjf, pri, ppri, rr (default all)\n");
+	fprintf(stderr, "  -c  core counts (default 1,2,4)\n");
+	fprintf(stderr, "  -q  quanta to run rr with (default 1,2,4)\n");
+	fprintf(stderr, "  -j  worker threads (default: one per online CPU)\n");
+	fprintf(stderr, "  -m  multi-queue: run every cell with a run queue per core, as the simulator's -m\n");
+}
+
+int main(int argc, char **argv)
+{
+	int c, i, j, k, t;
+	int schemes[RR + 1] = { FCFS, SJF, PSJF, PRI, PPRI, RR }, scheme_count = RR + 1;
+	int core_counts[MAX_GRID] = { 1, 2, 4 }, core_count = 3;
+	int quanta[MAX_GRID] = { 1, 2, 4 }, quantum_count = 3;
+	int threads = sysconf(_SC_NPROCESSORS_ONLN);
+	queue_mode_t mode = QUEUE_SHARED;
+	char *file_name = NULL;
+
+	/*
+	 * Parse command line options.
+	 */
+	while ((c = getopt(argc, argv, "s:c:q:j:mo:")) != -1)
+	{
+		switch (c)
+		{
+			case 's':
+				if (!(scheme_count = parse_schemes(optarg, schemes)))
+				{
+					fprintf(stderr, "Option -s <schemes> requires a list of fcfs, sjf, psjf, pri, ppri or rr.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'c':
+				if (!(core_count = parse_list(optarg, core_counts, MAX_GRID)))
+				{
+					fprintf(stderr, "Option -c <cores> requires a list of positive numbers.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'q':
+				if (!(quantum_count = parse_list(optarg, quanta, MAX_GRID)))
+				{
+					fprintf(stderr, "Option -q <quanta> requires a list of positive numbers.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'j':
+				threads = atoi(optarg);
+				if (threads <= 0)
+				{
+					fprintf(stderr, "Option -j <threads> requires a positive number.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'm':
+				mode = QUEUE_PER_CORE;
+				break;
+
+			case 'o':
+				file_name = optarg;
+				break;
+
+			default:
+				print_usage(argv[0]);
+				return 1;
+		}
+	}
+
+	if (optind == argc)
+	{
+		fprintf(stderr, "At least one input file is required.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+
+	/*
+	 * Open the output first, so a bad path fails before any run rather than after
+	 * the whole grid.
+	 */
+	FILE *out = file_name ? fopen(file_name, "w") : stdout;
+	if (out == NULL)
+	{
+		fprintf(stderr, "Unable to open file \"%s\".\n", file_name);
+		return 2;
+	}
+
+
+	/*
+	 * Load every trace once.
+	 */
+	int trace_count = argc - optind;
+	sweep_trace_t *traces = calloc(trace_count, sizeof(sweep_trace_t));
+
+	for (t = 0; t < trace_count; t++)
+	{
+		if (!load_trace(&traces[t], argv[optind + t]))
+		{
+			fprintf(stderr, "Unable to load trace \"%s\".\n", argv[optind + t]);
+			return 2;
+		}
+	}
+
+
+	/*
+	 * Lay out the grid and run it on the pool.
+	 */
+	sweep_pool_t pool;
+	pool.runs = calloc(trace_count * scheme_count * core_count * quantum_count, sizeof(sweep_run_t));
+	pool.count = 0;
+	pool.next = 0;
+	pthread_mutex_init(&pool.lock, NULL);
+
+	for (t = 0; t < trace_count; t++)
+		for (i = 0; i < scheme_count; i++)
+			for (j = 0; j < core_count; j++)
+				for (k = 0; k < (schemes[i] == RR ? quantum_count : 1); k++)
+				{
+					sweep_run_t *run = &pool.runs[pool.count++];
+					run->trace = &traces[t];
+					run->scheme = schemes[i];
+					run->cores = core_counts[j];
+					run->quantum = (schemes[i] == RR) ? quanta[k] : 0;
+					run->mode = mode;
+				}
+
+	if (threads > pool.count)
+		threads = pool.count;
+
+	pthread_t *workers = malloc(threads * sizeof(pthread_t));
+	for (i = 0; i < threads; i++)
+		pthread_create(&workers[i], NULL, worker, &pool);
+	for (i = 0; i < threads; i++)
+		pthread_join(workers[i], NULL);
+
+
+	/*
+	 * Print the table, in grid order.
+	 */
+	int failed = 0;
+	fprintf(out, "%-24s %-6s %5s %7s %12s %12s %12s\n", "trace", "scheme", "cores", "quantum", "waiting", "turnaround", "response");
+	for (i = 0; i < pool.count; i++)
+	{
+		sweep_run_t *run = &pool.runs[i];
+
+		fprintf(out, "%-24s %-6s %5d %7d ", run->trace->file_name, scheme_names[run->scheme], run->cores, run->quantum);
+		if (run->status == RUN_OK)
+			fprintf(out, "%12.2f %12.2f %12.2f\n", run->waiting, run->turnaround, run->response);
+		else
+		{
+			fprintf(out, "%12s %12s %12s\n", "failed", "failed", "failed");
+			failed++;
+		}
+	}
+
+	if (file_name)
+		fclose(out);
+
+	pthread_mutex_destroy(&pool.lock);
+	free(workers);
+	free(pool.runs);
+	for (t = 0; t < trace_count; t++)
+		free_trace(&traces[t]);
+	free(traces);
+
+	return failed ? 3 : 0;
+}
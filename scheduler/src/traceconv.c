@@ -0,0 +1,98 @@
+/*
+ * Converts a trace between the CSV layout of examples/procN.csv and the
+ * binary layout described in libtrace.h, so large traces are parsed once
+ * and replayed from the binary form afterwards.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "libtrace/libtrace.h"
+
+
+void print_usage(char *program_name)
+{
+	fprintf(stderr, "Usage: %s <input trace> <output trace>\n", program_name);
+	fprintf(stderr, "       %s examples/proc1.csv proc1.trace\n", program_name);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "A CSV input is written as a binary trace, a binary input as CSV.\n");
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 3)
+	{
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	trace_t trace;
+	int opened = trace_open(&trace, argv[1]);
+	if (opened == -1)
+	{
+		fprintf(stderr, "Unable to open file \"%s\".\n", argv[1]);
+		return 2;
+	}
+	else if (opened == -2)
+	{
+		fprintf(stderr, "Illegal file format.\n");
+		return 2;
+	}
+
+	FILE *out = fopen(argv[2], "wb");
+	if (out == NULL)
+	{
+		fprintf(stderr, "Unable to open file \"%s\".\n", argv[2]);
+		trace_close(&trace);
+		return 2;
+	}
+
+	trace_header_t header = { "", 0, 0, 0, 0, 0 };
+	trace_record_t record;
+	int to_binary = (trace.format == TRACE_CSV);
+	int result;
+
+	// The header is written again once the count and arrival range are known
+	if (to_binary)
+		trace_write_header(out, &header);
+	else
+		fprintf(out, "\"Arrival time\",\"Run time\",\"Priority\"\n");
+
+	while ((result = trace_next(&trace, &record)) == 1)
+	{
+		if (header.count == 0 || record.arrival_time < header.first_arrival)
+			header.first_arrival = record.arrival_time;
+		if (header.count == 0 || record.arrival_time > header.last_arrival)
+			header.last_arrival = record.arrival_time;
+		header.count++;
+
+		if (to_binary)
+			trace_write_record(out, &record);
+		else
+			fprintf(out, "%d,%d,%d\n", record.arrival_time, record.run_time, record.priority);
+	}
+
+	if (result == -1)
+	{
+		fprintf(stderr, "Illegal file format (line %d).\n", trace.line);
+		fclose(out);
+		trace_close(&trace);
+		return 2;
+	}
+
+	if (to_binary)
+	{
+		rewind(out);
+		trace_write_header(out, &header);
+	}
+
+	trace_close(&trace);
+
+	if (fclose(out) != 0)
+	{
+		fprintf(stderr, "Unable to write file \"%s\".\n", argv[2]);
+		return 2;
+	}
+
+	return 0;
+}
@@ -0,0 +1,448 @@
+/*
+ * Generates synthetic workloads for the simulator.  Traces are deterministic
+ * for a given seed and libm, and written either as CSV in the examples/procN.csv layout
+ * or as a binary trace (see libtrace.h).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <limits.h>
+#include <math.h>
+
+#include "libtrace/libtrace.h"
+
+
+#define MAX_PRIORITY_LEVELS 64
+
+typedef enum { ARRIVAL_POISSON = 0, ARRIVAL_ONOFF } arrival_process_t;
+typedef enum { RUN_EXPONENTIAL = 0, RUN_PARETO, RUN_BIMODAL } run_distribution_t;
+
+/*
+ * Arrivals: a Poisson process of the given rate, or an on/off source that is
+ * Poisson at rate while on and silent while off, with exponentially distributed
+ * on and off periods of mean on_time and off_time.
+ */
+typedef struct _arrival_model_t
+{
+	arrival_process_t process;
+	double rate, on_time, off_time;
+} arrival_model_t;
+
+/*
+ * Run times: exponential with mean a, Pareto with shape a and minimum b, or
+ * bimodal with short runs of mean a, long runs of mean b and a fraction p of
+ * long runs.  Run times are rounded up to at least one time unit.
+ */
+typedef struct _run_model_t
+{
+	run_distribution_t distribution;
+	double a, b, p;
+} run_model_t;
+
+/*
+ * Priorities 0..levels-1, drawn with the given relative weights.
+ */
+typedef struct _priority_model_t
+{
+	int levels;
+	double cumulative[MAX_PRIORITY_LEVELS];
+} priority_model_t;
+
+
+/*
+ * xoshiro256** seeded through splitmix64, so every seed gives the same stream of
+ * numbers on every platform.  The distributions are shaped with log() and pow(),
+ * whose last bits can differ between libm builds, so traces are only guaranteed
+ * to match between machines with the same libm.
+ */
+typedef struct _rng_t
+{
+	uint64_t s[4];
+} rng_t;
+
+static uint64_t rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+void rng_seed(rng_t *rng, uint64_t seed)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+	{
+		uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		rng->s[i] = z ^ (z >> 31);
+	}
+}
+
+uint64_t rng_next(rng_t *rng)
+{
+	uint64_t *s = rng->s;
+	uint64_t result = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+
+	return result;
+}
+
+/*
+ * Uniform on (0, 1]; never 0, so it is safe to take its log.
+ */
+double rng_uniform(rng_t *rng)
+{
+	return ((rng_next(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+double rng_exponential(rng_t *rng, double mean)
+{
+	return -mean * log(rng_uniform(rng));
+}
+
+
+double next_interarrival(rng_t *rng, arrival_model_t *model, int *on, double *phase_left)
+{
+	if (model->process == ARRIVAL_POISSON)
+		return rng_exponential(rng, 1.0 / model->rate);
+
+	double gap = 0;
+	while (1)
+	{
+		if (*on)
+		{
+			double next = rng_exponential(rng, 1.0 / model->rate);
+			if (next <= *phase_left)
+			{
+				*phase_left -= next;
+				return gap + next;
+			}
+
+			gap += *phase_left;
+			*on = 0;
+			*phase_left = rng_exponential(rng, model->off_time);
+		}
+		else
+		{
+			gap += *phase_left;
+			*on = 1;
+			*phase_left = rng_exponential(rng, model->on_time);
+		}
+	}
+}
+
+int next_run_time(rng_t *rng, run_model_t *model)
+{
+	double run_time;
+
+	if (model->distribution == RUN_EXPONENTIAL)
+		run_time = rng_exponential(rng, model->a);
+	else if (model->distribution == RUN_PARETO)
+		run_time = model->b / pow(rng_uniform(rng), 1.0 / model->a);
+	else if (rng_uniform(rng) <= model->p)
+		run_time = rng_exponential(rng, model->b);
+	else
+		run_time = rng_exponential(rng, model->a);
+
+	if (run_time > INT_MAX)
+		return INT_MAX;
+	return run_time < 1 ? 1 : (int)ceil(run_time);
+}
+
+int next_priority(rng_t *rng, priority_model_t *model)
+{
+	double u = rng_uniform(rng) * model->cumulative[model->levels - 1];
+	int level = 0;
+
+	while (level < model->levels - 1 && u > model->cumulative[level])
+		level++;
+	return level;
+}
+
+
+/*
+ * Parses "name:x,y,z" into up to max numbers following the name.  Returns how many
+ * numbers were read, or -1 if name does not match.
+ */
+int parse_spec(const char *spec, const char *name, double *values, int max)
+{
+	size_t len = strlen(name);
+	int count = 0;
+
+	if (strncasecmp(spec, name, len) != 0 || (spec[len] != ':' && spec[len] != '\0'))
+		return -1;
+
+	const char *s = spec + len;
+	while (*s == ':' || *s == ',')
+	{
+		char *end;
+		double value = strtod(s + 1, &end);
+
+		if (end == s + 1 || count == max)
+			return count;
+
+		values[count++] = value;
+		s = end;
+	}
+
+	return count;
+}
+
+int parse_arrivals(const char *spec, arrival_model_t *model)
+{
+	double v[3];
+
+	if (parse_spec(spec, "poisson", v, 1) == 1 && v[0] > 0)
+	{
+		model->process = ARRIVAL_POISSON;
+		model->rate = v[0];
+		return 1;
+	}
+
+	if (parse_spec(spec, "onoff", v, 3) == 3 && v[0] > 0 && v[1] > 0 && v[2] >= 0)
+	{
+		model->process = ARRIVAL_ONOFF;
+		model->rate = v[0];
+		model->on_time = v[1];
+		model->off_time = v[2];
+		return 1;
+	}
+
+	return 0;
+}
+
+int parse_run_times(const char *spec, run_model_t *model)
+{
+	double v[3];
+
+	if (parse_spec(spec, "exp", v, 1) == 1 && v[0] > 0)
+	{
+		model->distribution = RUN_EXPONENTIAL;
+		model->a = v[0];
+		return 1;
+	}
+
+	if (parse_spec(spec, "pareto", v, 2) == 2 && v[0] > 0 && v[1] > 0)
+	{
+		model->distribution = RUN_PARETO;
+		model->a = v[0];
+		model->b = v[1];
+		return 1;
+	}
+
+	if (parse_spec(spec, "bimodal", v, 3) == 3 && v[0] > 0 && v[1] > 0 && v[2] >= 0 && v[2] <= 1)
+	{
+		model->distribution = RUN_BIMODAL;
+		model->a = v[0];
+		model->b = v[1];
+		model->p = v[2];
+		return 1;
+	}
+
+	return 0;
+}
+
+int parse_priorities(const char *spec, priority_model_t *model)
+{
+	double total = 0;
+	const char *s = spec;
+
+	model->levels = 0;
+	while (*s)
+	{
+		char *end;
+		double weight = strtod(s, &end);
+
+		if (end == s || weight < 0 || model->levels == MAX_PRIORITY_LEVELS)
+			return 0;
+
+		total += weight;
+		model->cumulative[model->levels++] = total;
+
+		s = end;
+		if (*s == ',')
+			s++;
+		else if (*s != '\0')
+			return 0;
+	}
+
+	return model->levels > 0 && total > 0;
+}
+
+
+void print_usage(char *program_name)
+{
+	fprintf(stderr, "Usage: %s -n <jobs> [-s <seed>] [-a <arrivals>] [-r <run times>] [-p <weights>] [-b] [-o <output file>]\n", program_name);
+	fprintf(stderr, "       %s -n 1000000 -s 7 -a onoff:2,50,200 -r pareto:1.5,2 -p 1,1,8 -o big.csv\n", program_name);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "  -a  poisson:<rate> (default poisson:0.5) or onoff:<rate>,<mean on time>,<mean off time>\n");
+	fprintf(stderr, "  -r  exp:<mean> (default exp:8), pareto:<shape>,<minimum> or bimodal:<short mean>,<long mean>,<long fraction>\n");
+	fprintf(stderr, "  -p  relative weight of each priority level, from 0 up (default 1,1,1,1)\n");
+	fprintf(stderr, "  -b  write a binary trace instead of CSV (requires -o)\n");
+}
+
+int main(int argc, char **argv)
+{
+	int c;
+	long long jobs = -1;
+	uint64_t seed = 1;
+	int binary = 0;
+	char *file_name = NULL;
+
+	arrival_model_t arrivals = { ARRIVAL_POISSON, 0.5, 0, 0 };
+	run_model_t run_times = { RUN_EXPONENTIAL, 8, 0, 0 };
+	priority_model_t priorities;
+	parse_priorities("1,1,1,1", &priorities);
+
+	/*
+	 * Parse command line options.
+	 */
+	while ((c = getopt(argc, argv, "n:s:a:r:p:bo:")) != -1)
+	{
+		switch (c)
+		{
+			case 'n':
+				jobs = atoll(optarg);
+				break;
+
+			case 's':
+				seed = strtoull(optarg, NULL, 10);
+				break;
+
+			case 'a':
+				if (!parse_arrivals(optarg, &arrivals))
+				{
+					fprintf(stderr, "Option -a <arrivals> is not a valid arrival process.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'r':
+				if (!parse_run_times(optarg, &run_times))
+				{
+					fprintf(stderr, "Option -r <run times> is not a valid run time distribution.\n");
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'p':
+				if (!parse_priorities(optarg, &priorities))
+				{
+					fprintf(stderr, "Option -p <weights> requires up to %d non-negative weights.\n", MAX_PRIORITY_LEVELS);
+					print_usage(argv[0]);
+					return 1;
+				}
+				break;
+
+			case 'b':
+				binary = 1;
+				break;
+
+			case 'o':
+				file_name = optarg;
+				break;
+
+			default:
+				print_usage(argv[0]);
+				return 1;
+		}
+	}
+
+	if (jobs < 0 || jobs > INT_MAX || optind != argc)
+	{
+		fprintf(stderr, "Required option -n <jobs> is not present.\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	if (binary && file_name == NULL)
+	{
+		fprintf(stderr, "Option -b requires an output file (-o).\n");
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	FILE *out = file_name ? fopen(file_name, "wb") : stdout;
+	if (out == NULL)
+	{
+		fprintf(stderr, "Unable to open file \"%s\".\n", file_name);
+		return 2;
+	}
+	setvbuf(out, NULL, _IOFBF, 1 << 20);
+
+
+	/*
+	 * Generate the jobs.  The binary header is written again once the arrival range
+	 * is known.
+	 */
+	trace_header_t header = { "", 0, 0, 0, 0, 0 };
+	trace_record_t record;
+	rng_t rng;
+	double clock = 0, phase_left = 0;
+	int on = 0;
+	long long i;
+
+	rng_seed(&rng, seed);
+	if (arrivals.process == ARRIVAL_ONOFF)
+	{
+		on = 1;
+		phase_left = rng_exponential(&rng, arrivals.on_time);
+	}
+
+	if (binary)
+		trace_write_header(out, &header);
+	else
+		fprintf(out, "\"Arrival time\",\"Run time\",\"Priority\"\n");
+
+	for (i = 0; i < jobs; i++)
+	{
+		if (i > 0)
+			clock += next_interarrival(&rng, &arrivals, &on, &phase_left);
+
+		if (clock > INT_MAX)
+		{
+			fprintf(stderr, "Arrival times overflow after %lld jobs; raise the arrival rate.\n", i);
+			break;
+		}
+
+		record.arrival_time = (int)clock;
+		record.run_time = next_run_time(&rng, &run_times);
+		record.priority = next_priority(&rng, &priorities);
+
+		if (header.count == 0)
+			header.first_arrival = record.arrival_time;
+		header.last_arrival = record.arrival_time;
+		header.count++;
+
+		if (binary)
+			trace_write_record(out, &record);
+		else
+			fprintf(out, "%d,%d,%d\n", record.arrival_time, record.run_time, record.priority);
+	}
+
+	if (binary)
+	{
+		rewind(out);
+		trace_write_header(out, &header);
+	}
+
+	if (fclose(out) != 0)
+	{
+		fprintf(stderr, "Unable to write file \"%s\".\n", file_name ? file_name : "stdout");
+		return 2;
+	}
+
+	return i == jobs ? 0 : 2;
+}